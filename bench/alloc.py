@@ -0,0 +1,197 @@
+#!/usr/bin/env python3
+"""compare allocators: glibc malloc, jemalloc and tcmalloc (LD_PRELOAD),
+each with pymalloc in front (the default) and without (PYTHONMALLOC=malloc)
+
+each configuration runs a long allocation churn workload reporting
+throughput, peak rss and rss once everything is released (back to idle),
+and with ``--pyperformance`` the allocation heavy pyperformance benchmarks
+(stored as ``pyperformance-alloc`` under flavour ``<flavour>+<config>``).
+"""
+from __future__ import annotations
+
+import argparse
+import glob
+import json
+import os.path
+import subprocess
+import sys
+from collections.abc import Sequence
+from typing import NamedTuple
+
+import benchlib
+
+PYPERFORMANCE = (
+    'async_tree', 'deepcopy', 'gc_collect', 'go', 'json_dumps', 'json_loads',
+    'pickle', 'raytrace', 'unpickle', 'xml_etree',
+)
+ALLOCATORS = {
+    'glibc': None,
+    'jemalloc': '/usr/lib/*/libjemalloc.so.2',
+    'tcmalloc': '/usr/lib/*/libtcmalloc_minimal.so.4',
+}
+
+CHURN = '''\
+import gc, json, random, sys, time
+
+def status(field):
+    with open('/proc/self/status') as f:
+        for line in f:
+            if line.startswith(f'{field}:'):
+                return int(line.split()[1]) * 1024
+
+rounds, size, working_set = map(int, sys.argv[1:])
+rng = random.Random(0)
+
+def batch():
+    ret = []
+    for i in range(size):
+        k = rng.random()
+        if k < .4:
+            ret.append({'id': i, 'name': f'item-{i}', 'tags': [str(i)] * 3})
+        elif k < .7:
+            ret.append([i, float(i), str(i) * 5])
+        elif k < .95:
+            ret.append((i, f'{i:08x}', b'x' * rng.randrange(8, 512)))
+        else:
+            ret.append(bytearray(rng.randrange(512, 16384)))
+    return ret
+
+start = status('VmRSS')
+live = [batch() for _ in range(working_set)]
+survivors = []
+t0 = time.perf_counter()
+for _ in range(rounds):
+    evicted = live.pop(rng.randrange(len(live)))
+    # a few objects of every batch outlive it, fragmenting the heap
+    survivors.extend(evicted[::64])
+    del survivors[:-size]
+    live.append(batch())
+elapsed = time.perf_counter() - t0
+peak = status('VmHWM')
+
+del live, survivors, evicted
+gc.collect()
+time.sleep(1)
+print(json.dumps({
+    'throughput': rounds * size / elapsed,
+    'start_rss': start,
+    'peak_rss': peak,
+    'idle_rss': status('VmRSS'),
+}))
+'''
+
+
+class Config(NamedTuple):
+    name: str
+    preload: str | None
+    pymalloc: bool
+
+    @property
+    def env(self) -> dict[str, str]:
+        ret = {}
+        if self.preload:
+            ret['LD_PRELOAD'] = self.preload
+        if not self.pymalloc:
+            ret['PYTHONMALLOC'] = 'malloc'
+        return ret
+
+
+def _configs() -> list[Config]:
+    ret = []
+    for name, pattern in ALLOCATORS.items():
+        if pattern is None:
+            preload = None
+        else:
+            found = sorted(glob.glob(pattern))
+            if not found:
+                print(f'{name}: {pattern} not found', file=sys.stderr)
+                continue
+            preload = found[0]
+        ret.append(Config(f'{name}+pymalloc', preload, True))
+        ret.append(Config(name, preload, False))
+    return ret
+
+
+def main(argv: Sequence[str] | None = None) -> int:
+    parser = argparse.ArgumentParser(
+        description=__doc__.splitlines()[0],
+        formatter_class=argparse.RawDescriptionHelpFormatter,
+        epilog='\n'.join(__doc__.splitlines()[1:]),
+    )
+    parser.add_argument('--python', default='python3.13')
+    parser.add_argument('--rounds', type=int, default=2000)
+    parser.add_argument('--batch-size', type=int, default=5000)
+    parser.add_argument('--working-set', type=int, default=64)
+    parser.add_argument(
+        '--pyperformance', metavar='PYTHON',
+        help='also run bench/runner.py with this python (which has '
+             'pyperformance installed) for every configuration',
+    )
+    benchlib.add_output_args(parser)
+    args = parser.parse_args(argv)
+
+    metrics = {}
+    rows = [('config', 'objects/s', 'peak rss', 'idle rss')]
+    configs = _configs()
+    for config in configs:
+        out = subprocess.check_output(
+            (
+                args.python, '-c', CHURN,
+                str(args.rounds), str(args.batch_size), str(args.working_set),
+            ),
+            env={**os.environ, **config.env},
+        )
+        churn = json.loads(out)
+        metrics[f'{config.name}/throughput'] = benchlib.Metric(
+            churn['throughput'], 'objects/s', 'higher',
+        )
+        metrics[f'{config.name}/peak_rss'] = benchlib.Metric(
+            churn['peak_rss'], 'B',
+        )
+        metrics[f'{config.name}/idle_rss'] = benchlib.Metric(
+            churn['idle_rss'], 'B',
+        )
+        rows.append((
+            config.name, f'{churn["throughput"]:,.0f}',
+            f'{churn["peak_rss"] / 2**20:.1f} MiB',
+            f'{churn["idle_rss"] / 2**20:.1f} MiB',
+        ))
+
+    build = benchlib.build_info(args.python)
+    benchlib.write_result(
+        args, 'alloc', metrics,
+        build=build,
+        metadata={
+            'configs': {c.name: c.env for c in configs},
+            'rounds': args.rounds,
+            'batch_size': args.batch_size,
+            'working_set': args.working_set,
+        },
+    )
+    benchlib.step_summary(
+        f'## alloc {build["dist"]} {args.flavour}\n\n'
+        f'{benchlib.format_table(rows)}',
+    )
+
+    if args.pyperformance:
+        runner = os.path.join(os.path.dirname(__file__), 'runner.py')
+        for config in configs:
+            if config.name == 'glibc+pymalloc':
+                flavour = args.flavour
+            else:
+                flavour = f'{args.flavour}+{config.name}'
+            subprocess.check_call((
+                args.pyperformance, runner,
+                f'--python={args.python}',
+                f'--benchmarks={",".join(PYPERFORMANCE)}',
+                '--name=pyperformance-alloc',
+                f'--flavour={flavour}',
+                f'--output-dir={args.output_dir}',
+                f'--date={args.date}',
+                *(f'--env={k}={v}' for k, v in config.env.items()),
+            ))
+    return 0
+
+
+if __name__ == '__main__':
+    raise SystemExit(main())
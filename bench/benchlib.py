@@ -0,0 +1,162 @@
+"""helpers shared by the benchmark scripts
+
+results are stored one json file per benchmark per night:
+
+    <output-dir>/<dist>/<flavour>/<benchmark>/<date>.json
+
+which is also the layout of the ``bench-results`` branch.
+"""
+from __future__ import annotations
+
+import argparse
+import datetime
+import json
+import os.path
+import subprocess
+from collections.abc import Iterable
+from typing import Any
+from typing import NamedTuple
+
+import buildinfo
+
+
+class Metric(NamedTuple):
+    value: float
+    unit: str
+    better: str = 'lower'
+    stdev: float | None = None
+
+
+def add_output_args(parser: argparse.ArgumentParser) -> None:
+    parser.add_argument(
+        '--output-dir', default='results',
+        help='write results under this directory (default: %(default)s)',
+    )
+    parser.add_argument(
+        '--flavour', default=os.environ.get('BENCH_FLAVOUR', 'deb'),
+        help='name of the build flavour being measured (default: %(default)s)',
+    )
+    # one night's jobs can run past midnight: the workflow computes the
+    # date once and passes it to all of them
+    parser.add_argument(
+        '--date',
+        default=(
+            os.environ.get('BENCH_DATE') or
+            datetime.datetime.now(datetime.timezone.utc).date().isoformat()
+        ),
+        type=datetime.date.fromisoformat,
+        help='date of the nightly being measured (default: $BENCH_DATE, '
+             'or today)',
+    )
+
+
+def build_info(python: str) -> dict[str, Any]:
+    """bench/buildinfo.py for another interpreter"""
+    script = os.path.join(os.path.dirname(__file__), 'buildinfo.py')
+    return json.loads(subprocess.check_output((python, script)))
+
+
+def result_path(
+        root: str,
+        dist: str,
+        flavour: str,
+        benchmark: str,
+        date: datetime.date,
+) -> str:
+    return os.path.join(root, dist, flavour, benchmark, f'{date}.json')
+
+
+def write_result(
+        args: argparse.Namespace,
+        benchmark: str,
+        metrics: dict[str, Metric],
+        *,
+        build: dict[str, Any] | None = None,
+        metadata: dict[str, Any] | None = None,
+) -> str:
+    if build is None:
+        build = buildinfo.build_info()
+    dist = build['dist'] or 'unknown'
+    result = {
+        'benchmark': benchmark,
+        'date': str(args.date),
+        'dist': dist,
+        'flavour': args.flavour,
+        'build': build,
+        'metadata': metadata or {},
+        'metrics': {k: v._asdict() for k, v in metrics.items()},
+    }
+
+    path = result_path(
+        args.output_dir, dist, args.flavour, benchmark, args.date,
+    )
+    os.makedirs(os.path.dirname(path), exist_ok=True)
+    with open(path, 'w') as f:
+        json.dump(result, f, indent=2, sort_keys=True)
+        f.write('\n')
+    print(f'wrote {path}')
+    return path
+
+
+def load_result(path: str) -> dict[str, Any]:
+    with open(path) as f:
+        return json.load(f)
+
+
+def iter_results(root: str) -> Iterable[dict[str, Any]]:
+    for dirpath, _, filenames in sorted(os.walk(root)):
+        for filename in sorted(filenames):
+            if filename.endswith('.json'):
+                yield load_result(os.path.join(dirpath, filename))
+
+
+def history(
+        root: str,
+        dist: str,
+        flavour: str,
+        benchmark: str,
+        *,
+        before: datetime.date,
+) -> list[dict[str, Any]]:
+    """previous results for this benchmark, oldest first"""
+    dirname = os.path.dirname(
+        result_path(root, dist, flavour, benchmark, before),
+    )
+    try:
+        filenames = sorted(os.listdir(dirname))
+    except OSError:
+        return []
+    return [
+        load_result(os.path.join(dirname, filename))
+        for filename in filenames
+        if filename.endswith('.json') and filename[:-5] < str(before)
+    ]
+
+
+def same_commit(sha: str | None, other: str | None) -> bool:
+    """whether two (possibly abbreviated) shas name the same commit
+
+    ``sys._git`` abbreviates to different lengths depending on the build
+    """
+    if not sha or not other:
+        return False
+    n = min(len(sha), len(other))
+    return sha[:n].lower() == other[:n].lower()
+
+
+def format_table(rows: list[tuple[str, ...]]) -> str:
+    """markdown table, suitable for $GITHUB_STEP_SUMMARY"""
+    header, *body = rows
+    lines = [
+        f'| {" | ".join(header)} |',
+        f'|{"|".join("---" for _ in header)}|',
+        *(f'| {" | ".join(row)} |' for row in body),
+    ]
+    return '\n'.join(lines) + '\n'
+
+
+def step_summary(text: str) -> None:
+    print(text)
+    if 'GITHUB_STEP_SUMMARY' in os.environ:
+        with open(os.environ['GITHUB_STEP_SUMMARY'], 'a') as f:
+            f.write(text + '\n')
@@ -0,0 +1,140 @@
+#!/usr/bin/env python3
+"""describe exactly which build of the interpreter is running
+
+run this with the interpreter being described -- everything is read from the
+running process (``sys.version``, ``sys._git``, ``sysconfig``) and from dpkg
+for the package which owns the executable.
+"""
+from __future__ import annotations
+
+import argparse
+import hashlib
+import json
+import os.path
+import platform
+import subprocess
+import sys
+import sysconfig
+from collections.abc import Sequence
+
+# the parts of the build which identify it -- two interpreters with the same
+# values for these are expected to perform the same
+IDENTITY = ('git_sha', 'package_version', 'cc', 'config_args', 'cflags')
+
+
+def _dpkg_query(*args: str) -> str | None:
+    try:
+        out = subprocess.check_output(
+            ('dpkg-query', *args), stderr=subprocess.DEVNULL, text=True,
+        )
+    except (OSError, subprocess.CalledProcessError):
+        return None
+    else:
+        return out.strip() or None
+
+
+def _package() -> tuple[str | None, str | None]:
+    out = _dpkg_query('--search', os.path.realpath(sys.executable))
+    if out is None:
+        return None, None
+    name = out.partition(':')[0]
+    return name, _dpkg_query('--show', '--showformat=${Version}', name)
+
+
+def _os_release() -> dict[str, str]:
+    try:
+        with open('/etc/os-release') as f:
+            lines = f.read().splitlines()
+    except OSError:
+        return {}
+
+    ret = {}
+    for line in lines:
+        k, eq, v = line.partition('=')
+        if eq:
+            ret[k] = v.strip('"')
+    return ret
+
+
+def _cpu_model() -> str | None:
+    try:
+        with open('/proc/cpuinfo') as f:
+            for line in f:
+                k, _, v = line.partition(':')
+                if k.strip() == 'model name':
+                    return v.strip()
+    except OSError:
+        pass
+    return None
+
+
+def build_info(
+        package_override: tuple[str, str] | None = None,
+) -> dict[str, object]:
+    _, git_branch, git_sha = getattr(sys, '_git', ('', '', ''))
+    package, package_version = package_override or _package()
+    config = sysconfig.get_config_vars()
+    os_release = _os_release()
+
+    info: dict[str, object] = {
+        'version': sys.version,
+        'hexversion': sys.hexversion,
+        'git_branch': git_branch or None,
+        'git_sha': git_sha or None,
+        'package': package,
+        'package_version': package_version,
+        'executable': os.path.realpath(sys.executable),
+        'compiler': platform.python_compiler(),
+        'cc': config.get('CC'),
+        'config_args': config.get('CONFIG_ARGS'),
+        'cflags': config.get('PY_CFLAGS'),
+        'cflags_nodist': config.get('PY_CFLAGS_NODIST'),
+        'ldflags': config.get('PY_LDFLAGS'),
+        'ldflags_nodist': config.get('PY_LDFLAGS_NODIST'),
+        'gil_disabled': bool(config.get('Py_GIL_DISABLED')),
+        'debug': bool(config.get('Py_DEBUG')),
+        'dist': os_release.get('VERSION_CODENAME'),
+        'os': os_release.get('PRETTY_NAME'),
+        'kernel': platform.release(),
+        'libc': ' '.join(platform.libc_ver()) or None,
+        'machine': platform.machine(),
+        'cpu': _cpu_model(),
+        'cpu_count': os.cpu_count(),
+    }
+    identity = json.dumps([info[k] for k in IDENTITY]).encode()
+    info['build_id'] = hashlib.sha256(identity).hexdigest()[:12]
+    return info
+
+
+def main(argv: Sequence[str] | None = None) -> int:
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument(
+        '--field',
+        help='print only this field (empty if it is unknown)',
+    )
+    parser.add_argument(
+        '--package', metavar='NAME=VERSION',
+        help='the package the interpreter comes from, when dpkg does not '
+             'know it (eg. copied into a container image)',
+    )
+    args = parser.parse_args(argv)
+
+    if args.package is not None:
+        name, eq, version = args.package.partition('=')
+        if not eq:
+            parser.error(f'--package: expected NAME=VERSION: {args.package}')
+        info = build_info((name, version))
+    else:
+        info = build_info()
+    if args.field is not None:
+        if args.field not in info:
+            parser.error(f'unknown field: {args.field}')
+        value = info[args.field]
+        print('' if value is None else value)
+    else:
+        print(json.dumps(info, indent=2, sort_keys=True))
+    return 0
+
+
+if __name__ == '__main__':
+    raise SystemExit(main())
@@ -0,0 +1,145 @@
+#!/usr/bin/env python3
+"""compare the flavours measured on the same night against a baseline flavour
+
+for every metric the cost relative to the baseline is computed (inverted for
+higher-is-better metrics, so above 1 is always worse); a difference counts
+as significant when it is larger than twice the combined relative standard
+deviation of the two measurements (or ``--threshold`` without one).
+
+flavours built from another upstream commit than the baseline are marked,
+their difference includes the source changes.  so are flavours measured on
+another cpu model than the baseline: runners differ by more than most flag
+variants do, none of their differences counts as significant.
+"""
+from __future__ import annotations
+
+import argparse
+import collections
+import math
+from collections.abc import Sequence
+from typing import Any
+from typing import NamedTuple
+
+import benchlib
+
+
+class Cost(NamedTuple):
+    metric: str
+    ratio: float
+    significant: bool
+
+
+def _costs(
+        result: dict[str, Any],
+        baseline: dict[str, Any],
+        threshold: float,
+) -> list[Cost]:
+    ret = []
+    for name, metric in sorted(result['metrics'].items()):
+        base = baseline['metrics'].get(name)
+        if base is None or not base['value'] or not metric['value']:
+            continue
+        ratio = metric['value'] / base['value']
+        if metric['better'] == 'higher':
+            ratio = 1 / ratio
+        rsds = [
+            m['stdev'] / m['value'] for m in (metric, base) if m.get('stdev')
+        ]
+        noise = 2 * math.sqrt(sum(rsd ** 2 for rsd in rsds)) if rsds else 0
+        ret.append(Cost(name, ratio, abs(ratio - 1) > max(noise, threshold)))
+    return ret
+
+
+def compare(
+        results: list[dict[str, Any]],
+        baseline: str,
+        threshold: float,
+        detail: Sequence[str] = (),
+) -> str:
+    # (dist, benchmark) -> flavour -> result
+    by_key: dict[tuple[str, str], dict[str, dict[str, Any]]]
+    by_key = collections.defaultdict(dict)
+    for result in results:
+        key = result['dist'], result['benchmark']
+        by_key[key][result['flavour']] = result
+
+    out = [f'## flavours compared to {baseline}\n']
+    for (dist, benchmark), flavours in sorted(by_key.items()):
+        if baseline not in flavours or len(flavours) < 2:
+            continue
+        base = flavours[baseline]
+        rows = [(
+            'flavour', 'geomean cost', 'slower', 'faster', 'largest change',
+        )]
+        details = []
+        for flavour, result in sorted(flavours.items()):
+            if flavour == baseline:
+                continue
+            costs = _costs(result, base, threshold)
+            if not costs:
+                continue
+            # otherwise the difference includes source changes
+            if benchlib.same_commit(
+                    result['build'].get('git_sha'),
+                    base['build'].get('git_sha'),
+            ):
+                label = flavour
+            else:
+                label = f'{flavour} (other commit)'
+            if result['build'].get('cpu') != base['build'].get('cpu'):
+                label = f'{label} (other cpu)'
+                costs = [c._replace(significant=False) for c in costs]
+            if flavour in detail:
+                details.extend((label, c) for c in costs if c.significant)
+            geomean = math.exp(
+                sum(math.log(c.ratio) for c in costs) / len(costs),
+            )
+            slower = [c for c in costs if c.significant and c.ratio > 1]
+            faster = [c for c in costs if c.significant and c.ratio < 1]
+            largest = max(costs, key=lambda c: abs(math.log(c.ratio)))
+            rows.append((
+                label, f'{geomean - 1:+.1%}', str(len(slower)),
+                str(len(faster)), f'{largest.metric} {largest.ratio - 1:+.1%}',
+            ))
+        if len(rows) > 1:
+            out.append(f'### {dist} {benchmark} ({base["date"]})\n')
+            out.append(benchlib.format_table(rows))
+        if details:
+            out.append('#### significant differences\n')
+            rows = [('flavour', 'metric', 'cost')]
+            for label, cost in details:
+                rows.append((label, cost.metric, f'{cost.ratio - 1:+.1%}'))
+            out.append(benchlib.format_table(rows))
+    return '\n'.join(out)
+
+
+def main(argv: Sequence[str] | None = None) -> int:
+    parser = argparse.ArgumentParser(
+        description=__doc__.splitlines()[0],
+        formatter_class=argparse.RawDescriptionHelpFormatter,
+        epilog='\n'.join(__doc__.splitlines()[1:]),
+    )
+    parser.add_argument('results', help='root of the results tree')
+    parser.add_argument('--baseline', default='upstream')
+    parser.add_argument(
+        '--date', help='night to compare (default: the latest one)',
+    )
+    parser.add_argument('--threshold', type=float, default=.01)
+    parser.add_argument(
+        '--detail', action='append', default=[], metavar='FLAVOUR',
+        help='also list every significant difference of this flavour, may '
+             'be repeated',
+    )
+    args = parser.parse_args(argv)
+
+    results = list(benchlib.iter_results(args.results))
+    date = args.date or max((r['date'] for r in results), default=None)
+    results = [r for r in results if r['date'] == date]
+    benchlib.step_summary(
+        compare(results, args.baseline, args.threshold, args.detail),
+    )
+    return 0
+
+
+if __name__ == '__main__':
+    raise SystemExit(main())
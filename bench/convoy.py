@@ -0,0 +1,166 @@
+#!/usr/bin/env python3
+"""measure the gil convoy effect: wake-up latency of i/o bound threads while
+0..N cpu bound threads run, for several ``sys.setswitchinterval()`` values
+
+two kinds of i/o threads are probed at the same time:
+- ``timer``: how late a 1 ms ``time.sleep()`` returns
+- ``socket``: time from a forked process sending a (timestamped) message
+  until a thread blocked in ``recv()`` has it
+
+run it once per interpreter, eg. for the free-threaded build (where the
+switch interval has no effect):
+
+    bench/convoy.py --python python3.13t --flavour deb-nogil
+"""
+from __future__ import annotations
+
+import argparse
+import json
+import subprocess
+from collections.abc import Sequence
+
+import benchlib
+
+WORKLOAD = '''\
+import json, os, socket, struct, sys, threading, time
+
+cpu_counts = json.loads(sys.argv[1])
+intervals = json.loads(sys.argv[2])
+duration = float(sys.argv[3])
+PERIOD = .001
+MESSAGE = struct.Struct('d')
+
+# perf_counter is CLOCK_MONOTONIC: comparable across processes
+parent, child = socket.socketpair()
+pid = os.fork()
+if pid == 0:
+    parent.close()
+    try:
+        while True:
+            time.sleep(PERIOD * 2)
+            child.send(MESSAGE.pack(time.perf_counter()))
+    except OSError:  # the parent is done
+        os._exit(0)
+child.close()
+
+def percentiles(values):
+    values = sorted(values)
+    def at(q):
+        return values[min(len(values) - 1, int(q * len(values)))]
+    return {'p50': at(.5), 'p99': at(.99), 'max': values[-1]}
+
+def spin(stop):
+    n = 0
+    while not stop.is_set():
+        n += 1
+
+def timer(stop, out):
+    while not stop.is_set():
+        t0 = time.perf_counter()
+        time.sleep(PERIOD)
+        out.append(time.perf_counter() - t0 - PERIOD)
+
+def receive(stop, out):
+    while not stop.is_set():
+        data = parent.recv(MESSAGE.size, socket.MSG_WAITALL)
+        out.append(time.perf_counter() - MESSAGE.unpack(data)[0])
+
+def drain():
+    # messages sent while nobody was receiving aren't wake-ups
+    parent.setblocking(False)
+    try:
+        while parent.recv(1 << 16):
+            pass
+    except BlockingIOError:
+        pass
+    parent.setblocking(True)
+
+results = {}
+for interval in intervals:
+    sys.setswitchinterval(interval)
+    for cpu in cpu_counts:
+        stop = threading.Event()
+        timer_out, socket_out = [], []
+        threads = [
+            threading.Thread(target=spin, args=(stop,)) for _ in range(cpu)
+        ]
+        threads += [
+            threading.Thread(target=timer, args=(stop, timer_out)),
+            threading.Thread(target=receive, args=(stop, socket_out)),
+        ]
+        drain()
+        for t in threads:
+            t.start()
+        time.sleep(duration)
+        stop.set()
+        for t in threads:
+            t.join()
+        key = f'{cpu}cpu/{interval * 1e3:g}ms'
+        results[f'timer/{key}'] = percentiles(timer_out)
+        results[f'socket/{key}'] = percentiles(socket_out)
+
+parent.close()
+os.waitpid(pid, 0)
+print(json.dumps(results))
+'''
+
+
+def main(argv: Sequence[str] | None = None) -> int:
+    parser = argparse.ArgumentParser(
+        description=__doc__.splitlines()[0],
+        formatter_class=argparse.RawDescriptionHelpFormatter,
+        epilog='\n'.join(__doc__.splitlines()[1:]),
+    )
+    parser.add_argument('--python', default='python3.13')
+    parser.add_argument(
+        '--cpu-threads', default='0,1,2,4', help='(default: %(default)s)',
+    )
+    parser.add_argument(
+        '--switch-intervals', default='.001,.005,.02',
+        help='seconds (default: %(default)s, .005 is the default interval)',
+    )
+    parser.add_argument(
+        '--duration', type=float, default=3,
+        help='seconds per configuration',
+    )
+    benchlib.add_output_args(parser)
+    args = parser.parse_args(argv)
+    cpu_counts = [int(s) for s in args.cpu_threads.split(',')]
+    intervals = [float(s) for s in args.switch_intervals.split(',')]
+
+    measured = json.loads(
+        subprocess.check_output((
+            args.python, '-c', WORKLOAD, json.dumps(cpu_counts),
+            json.dumps(intervals), str(args.duration),
+        )),
+    )
+
+    metrics = {}
+    rows = [('', 'p50', 'p99', 'max')]
+    for name, stats in measured.items():
+        for stat, value in stats.items():
+            metrics[f'{name}/{stat}'] = benchlib.Metric(value, 's')
+        rows.append((
+            name,
+            *(f'{stats[k] * 1e6:,.0f} µs' for k in ('p50', 'p99', 'max')),
+        ))
+
+    build = benchlib.build_info(args.python)
+    benchlib.write_result(
+        args, 'convoy', metrics,
+        build=build,
+        metadata={
+            'cpu_threads': cpu_counts,
+            'switch_intervals': intervals,
+            'duration': args.duration,
+        },
+    )
+    benchlib.step_summary(
+        f'## convoy {build["dist"]} {args.flavour}\n\n'
+        f'{benchlib.format_table(rows)}',
+    )
+    return 0
+
+
+if __name__ == '__main__':
+    raise SystemExit(main())
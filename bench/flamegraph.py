@@ -0,0 +1,309 @@
+#!/usr/bin/env python3
+"""profile pyperformance workloads with ``perf record`` and the perf
+trampoline, so python functions show up in the native stacks, and render
+flamegraphs
+
+the trampoline is ``-X perf_jit``: perf unwinds through its python frames
+with the unwind info of the jitdump.  ``-X perf`` trampolines have none, with
+dwarf unwinding (the nightly has no frame pointers) its stacks would end at
+the first trampoline, so it isn't used.
+
+for each benchmark and mode this writes to the output directory:
+- ``<benchmark>.<mode>.folded.gz``: the folded stacks
+- ``<benchmark>.<mode>.svg``: the flamegraph
+- ``<benchmark>.<mode>.grown.md``: when the folded stacks of a previous night
+  are in ``--previous``, the functions whose share of the samples grew the
+  most (also in the job summary)
+a benchmark which fails (or has no samples) has none of them.
+
+only the samples of the benchmark worker are kept, the share of the others
+(pyperformance itself, perf, the system) is summarized.
+"""
+from __future__ import annotations
+
+import argparse
+import collections
+import gzip
+import hashlib
+import html
+import os.path
+import re
+import shutil
+import subprocess
+import sys
+import tempfile
+from collections.abc import Iterable
+from collections.abc import Sequence
+
+import benchlib
+
+# the worker's frames are found by pyperformance's bm_<benchmark> directory:
+# only benchmarks with a directory of their own (not e.g. unpickle, which is
+# in bm_pickle)
+BENCHMARKS = (
+    'deltablue', 'go', 'json_dumps', 'nbody', 'pickle', 'raytrace',
+    'regex_v8', 'richards',
+)
+MODES = {
+    'perf_jit': {'PYTHON_PERF_JIT_SUPPORT': '1'},
+}
+OFFSET_RE = re.compile(r'\+0x[0-9a-f]+$')
+FRAME_HEIGHT = 16
+WIDTH = 1200
+
+
+def _record(
+        args: argparse.Namespace,
+        benchmark: str,
+        mode: str,
+        tmpdir: str,
+) -> str:
+    data = os.path.join(tmpdir, f'{benchmark}.{mode}.data')
+    env = {**os.environ, **MODES[mode]}
+    # the nightly isn't built with frame pointers, -g would lose the c
+    # frames (and with them the trampolines) of most samples; the jitdump
+    # carries the unwind info for the python frames
+    cmd = (
+        args.perf, 'record', '-F', str(args.frequency), '-o', data,
+        '--call-graph', 'dwarf', '-k', '1',
+        '--', args.pyperformance, '-m', 'pyperformance', 'run', '--fast',
+        f'--python={args.python}', f'--benchmarks={benchmark}',
+        f'--inherit-environ={",".join(MODES[mode])}',
+        f'--output={os.path.join(tmpdir, f"{benchmark}.{mode}.json")}',
+    )
+    subprocess.check_call(cmd, env=env)
+    injected = f'{data}.jit'
+    subprocess.check_call(
+        (args.perf, 'inject', '--jit', '-i', data, '-o', injected),
+    )
+    return subprocess.check_output(
+        (args.perf, 'script', '-i', injected), text=True, errors='replace',
+    )
+
+
+def collapse(
+        script: str,
+        keep: str,
+) -> tuple[collections.Counter[str], int]:
+    """fold ``perf script`` output, keeping stacks with a frame matching
+    ``keep`` (the benchmark workers), and count the samples dropped"""
+    ret: collections.Counter[str] = collections.Counter()
+    dropped = 0
+    for sample in script.split('\n\n'):
+        header, *lines = sample.strip('\n').splitlines() or ('',)
+        if not header:
+            continue
+        if not lines:
+            dropped += 1
+            continue
+        frames = []
+        for line in lines:
+            _, _, rest = line.strip().partition(' ')
+            sym = rest.rpartition(' (')[0] or rest
+            frames.append(OFFSET_RE.sub('', sym) or '[unknown]')
+        if not any(keep in frame for frame in frames):
+            dropped += 1
+            continue
+        comm = header.split()[0] if header.split() else '?'
+        ret[';'.join((comm, *reversed(frames)))] += 1
+    return ret, dropped
+
+
+def read_folded(path: str) -> collections.Counter[str]:
+    ret: collections.Counter[str] = collections.Counter()
+    with gzip.open(path, 'rt') as f:
+        for line in f:
+            stack, _, count = line.rstrip('\n').rpartition(' ')
+            ret[stack] += int(count)
+    return ret
+
+
+def write_folded(path: str, folded: collections.Counter[str]) -> None:
+    # mtime=0: identical stacks give identical files
+    with open(path, 'wb') as raw:
+        with gzip.GzipFile(fileobj=raw, mode='wb', mtime=0) as gz:
+            for stack, count in sorted(folded.items()):
+                gz.write(f'{stack} {count}\n'.encode())
+
+
+def _color(name: str) -> str:
+    h = int(hashlib.md5(name.encode()).hexdigest()[:4], 16) / 0xffff
+    if name.startswith('py::'):  # python functions, through the trampoline
+        return f'rgb({80 + int(h * 40)},{140 + int(h * 60)},{220})'
+    return f'rgb({220 + int(h * 35)},{100 + int(h * 100)},{50})'
+
+
+def render(folded: collections.Counter[str], title: str) -> str:
+    counts: collections.Counter[tuple[str, ...]] = collections.Counter()
+    for stack, count in folded.items():
+        path: tuple[str, ...] = ()
+        for frame in stack.split(';'):
+            path = (*path, frame)
+            counts[path] += count
+
+    total = sum(folded.values()) or 1
+    depth = max((len(path) for path in counts), default=0)
+    height = (depth + 2) * FRAME_HEIGHT
+    parts = [
+        f'<svg xmlns="http://www.w3.org/2000/svg" width="{WIDTH}" '
+        f'height="{height}" font-family="monospace" font-size="11">',
+        f'<text x="{WIDTH / 2}" y="{FRAME_HEIGHT - 4}" text-anchor="middle">'
+        f'{html.escape(title)} ({total} samples)</text>',
+    ]
+
+    # children are laid out in name order inside their parent
+    children: dict[tuple[str, ...], list[tuple[str, ...]]]
+    children = collections.defaultdict(list)
+    for path in counts:
+        children[path[:-1]].append(path)
+
+    todo = [((), 0.)]
+    while todo:
+        parent, x = todo.pop()
+        for path in sorted(children[parent]):
+            w = counts[path] / total * WIDTH
+            if w >= .5:
+                y = height - (len(path) + 1) * FRAME_HEIGHT
+                name = path[-1]
+                label = html.escape(name[:int(w / 7)]) if w > 21 else ''
+                pct = counts[path] / total
+                parts.append(
+                    f'<g><title>{html.escape(name)} ({counts[path]} samples, '
+                    f'{pct:.2%})</title><rect x="{x:.1f}" y="{y}" '
+                    f'width="{w:.1f}" height="{FRAME_HEIGHT - 1}" '
+                    f'fill="{_color(name)}"/><text x="{x + 2:.1f}" '
+                    f'y="{y + FRAME_HEIGHT - 4}">{label}</text></g>',
+                )
+                todo.append((path, x))
+            x += w
+    parts.append('</svg>')
+    return '\n'.join(parts) + '\n'
+
+
+def _shares(
+        folded: collections.Counter[str],
+) -> tuple[dict[str, float], dict[str, float]]:
+    total = sum(folded.values()) or 1
+    self_: collections.Counter[str] = collections.Counter()
+    inclusive: collections.Counter[str] = collections.Counter()
+    for stack, count in folded.items():
+        frames = stack.split(';')[1:]  # without the comm
+        if frames:
+            self_[frames[-1]] += count
+        for frame in set(frames):
+            inclusive[frame] += count
+    return (
+        {k: v / total for k, v in self_.items()},
+        {k: v / total for k, v in inclusive.items()},
+    )
+
+
+def diff(
+        before: collections.Counter[str],
+        after: collections.Counter[str],
+        top: int = 15,
+) -> list[tuple[str, ...]]:
+    """functions whose self share grew the most (inclusive share alongside)"""
+    self_before, incl_before = _shares(before)
+    self_after, incl_after = _shares(after)
+    grown = sorted(
+        set(self_before) | set(self_after),
+        key=lambda k: self_after.get(k, 0) - self_before.get(k, 0),
+        reverse=True,
+    )[:top]
+    rows = [('function', 'self', 'inclusive')]
+    for name in grown:
+        change = self_after.get(name, 0) - self_before.get(name, 0)
+        if change <= 0:
+            break
+        rows.append((
+            f'`{name}`',
+            f'{self_before.get(name, 0):.2%} -> {self_after.get(name, 0):.2%}',
+            f'{incl_before.get(name, 0):.2%} -> {incl_after.get(name, 0):.2%}',
+        ))
+    return rows
+
+
+def _summary(
+        title: str,
+        rows: Iterable[tuple[str, ...]],
+        path: str | None = None,
+) -> None:
+    rows = list(rows)
+    if len(rows) > 1:
+        text = f'### {title}\n\n{benchlib.format_table(rows)}'
+        benchlib.step_summary(text)
+        if path is not None:
+            with open(path, 'w') as f:
+                f.write(text)
+
+
+def main(argv: Sequence[str] | None = None) -> int:
+    parser = argparse.ArgumentParser(
+        description=__doc__.splitlines()[0],
+        formatter_class=argparse.RawDescriptionHelpFormatter,
+        epilog='\n'.join(__doc__.splitlines()[1:]),
+    )
+    parser.add_argument('--python', default='python3.13')
+    parser.add_argument(
+        '--pyperformance', default=sys.executable,
+        help='python with pyperformance installed (default: this one)',
+    )
+    parser.add_argument('--perf', default=shutil.which('perf') or 'perf')
+    parser.add_argument('--frequency', type=int, default=499)
+    parser.add_argument('--benchmarks', default=','.join(BENCHMARKS))
+    parser.add_argument(
+        '--modes', default=','.join(MODES),
+        help='(default: %(default)s)',
+    )
+    parser.add_argument('--output-dir', default='flamegraphs')
+    parser.add_argument(
+        '--previous', help='output directory of a previous night',
+    )
+    args = parser.parse_args(argv)
+
+    os.makedirs(args.output_dir, exist_ok=True)
+    samples = [('profile', 'kept', 'dropped')]
+    for benchmark in args.benchmarks.split(','):
+        for mode in args.modes.split(','):
+            name = f'{benchmark}.{mode}'
+            # the restored cache's, from an earlier night
+            for suffix in ('folded.gz', 'svg', 'grown.md'):
+                path = os.path.join(args.output_dir, f'{name}.{suffix}')
+                if os.path.exists(path):
+                    os.remove(path)
+            with tempfile.TemporaryDirectory() as tmpdir:
+                try:
+                    script = _record(args, benchmark, mode, tmpdir)
+                except subprocess.CalledProcessError as e:
+                    print(f'{name}: failed ({e}), skipping', file=sys.stderr)
+                    continue
+            folded, dropped = collapse(script, keep=f'bm_{benchmark}')
+            kept = sum(folded.values())
+            samples.append((
+                name, str(kept), f'{dropped / ((kept + dropped) or 1):.1%}',
+            ))
+            if not folded:
+                print(f'{name}: no samples, skipping', file=sys.stderr)
+                continue
+
+            folded_path = os.path.join(args.output_dir, f'{name}.folded.gz')
+            write_folded(folded_path, folded)
+            with open(os.path.join(args.output_dir, f'{name}.svg'), 'w') as f:
+                f.write(render(folded, name))
+
+            grown = os.path.join(args.output_dir, f'{name}.grown.md')
+            if args.previous:
+                previous = os.path.join(args.previous, f'{name}.folded.gz')
+                if os.path.exists(previous):
+                    _summary(
+                        f'{name}: grown since the previous night',
+                        diff(read_folded(previous), folded),
+                        grown,
+                    )
+    _summary('samples', samples)
+    return 0
+
+
+if __name__ == '__main__':
+    raise SystemExit(main())
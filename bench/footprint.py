@@ -0,0 +1,132 @@
+#!/usr/bin/env python3
+"""measure the resident (rss) and proportional (pss) memory of an idle
+interpreter: after startup, after importing a typical service's stdlib
+modules and per additional (idle) thread
+
+run it once per interpreter, eg. for the free-threaded build:
+
+    bench/footprint.py --python python3.13t --flavour deb-nogil
+"""
+from __future__ import annotations
+
+import argparse
+import json
+import math
+import statistics
+import subprocess
+from collections.abc import Sequence
+
+import benchlib
+from startup import IMPORTS
+
+SCRIPT = f'''\
+import sys
+
+def memory():
+    ret = {{}}
+    try:
+        f = open('/proc/self/smaps_rollup')
+    except OSError:  # before linux 4.14
+        f = open('/proc/self/status')
+    with f:
+        for line in f:
+            k, _, v = line.partition(':')
+            if k in {{'Rss', 'Pss', 'VmRSS'}}:
+                ret[k.replace('VmRSS', 'Rss')] = int(v.split()[0]) * 1024
+    return ret
+
+phases = {{'startup': memory()}}
+
+import {", ".join(IMPORTS)}
+phases['imports'] = memory()
+
+import threading
+stop = threading.Event()
+threads = [
+    threading.Thread(target=stop.wait) for _ in range(int(sys.argv[1]))
+]
+for t in threads:
+    t.start()
+phases['threads'] = memory()
+stop.set()
+for t in threads:
+    t.join()
+
+import json
+print(json.dumps(phases))
+'''
+
+
+def main(argv: Sequence[str] | None = None) -> int:
+    parser = argparse.ArgumentParser(
+        description=__doc__.splitlines()[0],
+        formatter_class=argparse.RawDescriptionHelpFormatter,
+        epilog='\n'.join(__doc__.splitlines()[1:]),
+    )
+    parser.add_argument('--python', default='python3.13')
+    parser.add_argument('--threads', type=int, default=32)
+    parser.add_argument('--runs', type=int, default=5)
+    benchlib.add_output_args(parser)
+    args = parser.parse_args(argv)
+
+    runs = [
+        json.loads(
+            subprocess.check_output(
+                (args.python, '-c', SCRIPT, str(args.threads)),
+            ),
+        )
+        for _ in range(args.runs)
+    ]
+
+    def median(phase: str, key: str) -> float:
+        values = [run[phase].get(key) for run in runs]
+        if None in values:
+            return float('nan')
+        return statistics.median(values)
+
+    metrics = {}
+    rows = [('', 'rss', 'pss')]
+    for phase in ('startup', 'imports'):
+        for key in ('Rss', 'Pss'):
+            metrics[f'{phase}/{key.lower()}'] = benchlib.Metric(
+                median(phase, key), 'B',
+            )
+        rows.append((
+            phase,
+            f'{median(phase, "Rss") / 2**20:.2f} MiB',
+            f'{median(phase, "Pss") / 2**20:.2f} MiB',
+        ))
+    for key in ('Rss', 'Pss'):
+        per_thread = (
+            median('threads', key) - median('imports', key)
+        ) / args.threads
+        metrics[f'per_thread/{key.lower()}'] = benchlib.Metric(
+            per_thread, 'B',
+        )
+    rows.append((
+        'per thread',
+        f'{metrics["per_thread/rss"].value / 2**10:.1f} KiB',
+        f'{metrics["per_thread/pss"].value / 2**10:.1f} KiB',
+    ))
+    # smaps_rollup is missing on old kernels
+    metrics = {k: v for k, v in metrics.items() if not math.isnan(v.value)}
+
+    build = benchlib.build_info(args.python)
+    benchlib.write_result(
+        args, 'footprint', metrics,
+        build=build,
+        metadata={
+            'imports': IMPORTS,
+            'threads': args.threads,
+            'runs': runs,
+        },
+    )
+    benchlib.step_summary(
+        f'## footprint {build["dist"]} {args.flavour}\n\n'
+        f'{benchlib.format_table(rows)}',
+    )
+    return 0
+
+
+if __name__ == '__main__':
+    raise SystemExit(main())
@@ -0,0 +1,216 @@
+#!/usr/bin/env python3
+"""measure a large heap workload with and without huge pages: walk a
+randomly linked multi-GiB heap of small objects, reporting throughput, the
+heap backed by huge pages and (with ``perf``) dTLB misses of the walk
+
+the configurations are runtime options of an unmodified interpreter:
+- ``default``: pymalloc (mimalloc on the free-threaded build)
+- ``malloc``, ``malloc+thp``: glibc malloc, without / with its huge page
+  tunable (glibc 2.35+, ignored before)
+- ``mimalloc+large``: mimalloc allowed to use large os pages (free-threaded)
+
+the ``hugepages`` flavour (tools/hugepage-arenas) runs ``default``.
+"""
+from __future__ import annotations
+
+import argparse
+import json
+import os
+import shutil
+import signal
+import statistics
+import subprocess
+import tempfile
+import time
+from collections.abc import Sequence
+
+import benchlib
+
+CONFIGS = {
+    'default': {},
+    'malloc': {'PYTHONMALLOC': 'malloc'},
+    'malloc+thp': {
+        'PYTHONMALLOC': 'malloc', 'GLIBC_TUNABLES': 'glibc.malloc.hugetlb=1',
+    },
+    'mimalloc+large': {'MIMALLOC_ALLOW_LARGE_OS_PAGES': '1'},
+}
+EVENTS = ('dTLB-loads', 'dTLB-load-misses')
+# a record (dict, str, int and its list slot) is about 300 bytes
+RECORD_SIZE = 300
+
+WORKLOAD = f'''\
+import json, random, sys, time
+
+heap, steps = map(int, sys.argv[1:])
+rng = random.Random(0)
+
+t0 = time.perf_counter()
+records = [
+    {{'id': i, 'name': f'record-{{i}}', 'next': None}}
+    for i in range(heap // {RECORD_SIZE})
+]
+order = list(range(len(records)))
+rng.shuffle(order)
+for a, b in zip(order, order[1:] + order[:1]):
+    records[a]['next'] = records[b]
+del order
+build = time.perf_counter() - t0
+
+def memory():
+    ret = {{}}
+    with open('/proc/self/smaps_rollup') as f:
+        for line in f:
+            k, _, v = line.partition(':')
+            if k in {{'Rss', 'AnonHugePages'}}:
+                ret[k] = int(v.split()[0]) * 1024
+    return ret
+
+print('ready', flush=True)
+sys.stdin.readline()
+
+r = records[0]
+total = 0
+t0 = time.perf_counter()
+for _ in range(steps):
+    r = r['next']
+    total += r['id']
+walk = time.perf_counter() - t0
+
+print(json.dumps({{'build': build, 'walk': walk, **memory()}}))
+'''
+
+
+def _perf_stat(output: str) -> dict[str, float]:
+    ret = {}
+    with open(output) as f:
+        for line in f:
+            value, _, rest = line.strip().partition(',')
+            event = rest.split(',')[1] if rest.count(',') else ''
+            if event in EVENTS:
+                try:
+                    ret[event] = float(value)
+                except ValueError:  # <not supported> in most vms
+                    pass
+    return ret
+
+
+def _run(
+        args: argparse.Namespace,
+        env: dict[str, str],
+) -> tuple[dict[str, float], dict[str, float]]:
+    proc = subprocess.Popen(
+        (
+            args.python, '-c', WORKLOAD,
+            str(args.heap * 2**20), str(args.steps),
+        ),
+        env={**os.environ, **env},
+        stdin=subprocess.PIPE, stdout=subprocess.PIPE, text=True,
+    )
+    assert proc.stdin is not None and proc.stdout is not None
+    assert proc.stdout.readline() == 'ready\n'
+
+    # count the walk only, not building the heap
+    with tempfile.NamedTemporaryFile() as perf_out:
+        perf = None
+        if args.perf:
+            perf = subprocess.Popen((
+                args.perf, 'stat', '-x,', '-o', perf_out.name,
+                '-e', ','.join(EVENTS), '-p', str(proc.pid),
+            ))
+            time.sleep(.5)  # attached
+        proc.stdin.write('\n')
+        proc.stdin.close()
+        result = json.loads(proc.stdout.read())
+        if proc.wait():
+            raise subprocess.CalledProcessError(proc.returncode, args.python)
+        counters = {}
+        if perf is not None:
+            perf.send_signal(signal.SIGINT)
+            if not perf.wait():
+                counters = _perf_stat(perf_out.name)
+    return result, counters
+
+
+def _sysfs(path: str) -> str | None:
+    try:
+        with open(path) as f:
+            return f.read().strip()
+    except OSError:
+        return None
+
+
+def main(argv: Sequence[str] | None = None) -> int:
+    parser = argparse.ArgumentParser(
+        description=__doc__.splitlines()[0],
+        formatter_class=argparse.RawDescriptionHelpFormatter,
+        epilog='\n'.join(__doc__.splitlines()[1:]),
+    )
+    parser.add_argument('--python', default='python3.13')
+    parser.add_argument(
+        '--configs', default='default,malloc,malloc+thp',
+        help='(default: %(default)s)',
+    )
+    parser.add_argument('--heap', type=int, default=2048, help='MiB')
+    parser.add_argument('--steps', type=int, default=20_000_000)
+    parser.add_argument('--runs', type=int, default=3)
+    parser.add_argument(
+        '--perf', default=shutil.which('perf'),
+        help='perf binary, to count dTLB misses (default: from PATH)',
+    )
+    benchlib.add_output_args(parser)
+    args = parser.parse_args(argv)
+    configs = {name: CONFIGS[name] for name in args.configs.split(',')}
+
+    metrics = {}
+    rows = [('config', 'steps/s', 'huge pages', 'dTLB misses/step')]
+    for name, env in configs.items():
+        runs = [_run(args, env) for _ in range(args.runs)]
+        throughput = [args.steps / result['walk'] for result, _ in runs]
+        huge = statistics.median(result['AnonHugePages'] for result, _ in runs)
+        rss = statistics.median(result['Rss'] for result, _ in runs)
+        metrics[f'{name}/throughput'] = benchlib.Metric(
+            statistics.mean(throughput), 'steps/s', 'higher',
+            statistics.stdev(throughput) if len(throughput) > 1 else None,
+        )
+        metrics[f'{name}/build'] = benchlib.Metric(
+            statistics.mean(result['build'] for result, _ in runs), 's',
+        )
+        metrics[f'{name}/rss'] = benchlib.Metric(rss, 'B')
+        metrics[f'{name}/anon_huge_pages'] = benchlib.Metric(
+            huge, 'B', 'higher',
+        )
+        misses = [
+            c['dTLB-load-misses'] for _, c in runs if 'dTLB-load-misses' in c
+        ]
+        if misses:
+            metrics[f'{name}/dtlb_misses_per_step'] = benchlib.Metric(
+                statistics.mean(misses) / args.steps, 'misses/step',
+            )
+        rows.append((
+            name, f'{metrics[f"{name}/throughput"].value:,.0f}',
+            f'{huge / rss:.0%}',
+            f'{statistics.mean(misses) / args.steps:.2f}' if misses else '-',
+        ))
+
+    build = benchlib.build_info(args.python)
+    benchlib.write_result(
+        args, 'hugepages', metrics,
+        build=build,
+        metadata={
+            'configs': configs,
+            'heap': args.heap * 2**20,
+            'steps': args.steps,
+            'runs': args.runs,
+            'thp': _sysfs('/sys/kernel/mm/transparent_hugepage/enabled'),
+            'nr_hugepages': _sysfs('/proc/sys/vm/nr_hugepages'),
+        },
+    )
+    benchlib.step_summary(
+        f'## hugepages {build["dist"]} {args.flavour}\n\n'
+        f'{benchlib.format_table(rows)}',
+    )
+    return 0
+
+
+if __name__ == '__main__':
+    raise SystemExit(main())
@@ -0,0 +1,165 @@
+#!/usr/bin/env python3
+"""measure the nightly container image (tools/build-oci): size of the archive
+and of its layers, time to load it and time from ``docker run`` to the first
+instruction of ``python3.13 -c pass``
+
+each layer is compared with the previous night's image (from ``--history``):
+the size of the layers which are not shared with it is what a host which
+pulled yesterday's image downloads.
+"""
+from __future__ import annotations
+
+import argparse
+import hashlib
+import json
+import os.path
+import statistics
+import subprocess
+import tarfile
+import time
+from collections.abc import Sequence
+
+import benchlib
+
+# set by oci/Dockerfile: the nightly the image was built from
+VERSION_LABEL = 'org.opencontainers.image.version'
+
+
+def _layers(archive: str) -> list[tuple[str, int]]:
+    """digest (of the uncompressed layer) and size of each layer"""
+    ret = []
+    with tarfile.open(archive) as tf:
+        f = tf.extractfile('manifest.json')
+        assert f is not None
+        manifest, = json.load(f)
+        for layer in manifest['Layers']:
+            f = tf.extractfile(layer)
+            assert f is not None
+            digest = hashlib.file_digest(f, 'sha256').hexdigest()
+            ret.append((f'sha256:{digest}', tf.getmember(layer).size))
+    return ret
+
+
+def _timed(*cmd: str) -> float:
+    t0 = time.perf_counter()
+    subprocess.check_call(cmd, stdout=subprocess.DEVNULL)
+    return time.perf_counter() - t0
+
+
+def main(argv: Sequence[str] | None = None) -> int:
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument('--image', required=True)
+    parser.add_argument('--archive', required=True)
+    parser.add_argument('--runs', type=int, default=20)
+    parser.add_argument(
+        '--history', default='history',
+        help='previous results to compare against (default: %(default)s)',
+    )
+    benchlib.add_output_args(parser)
+    parser.set_defaults(flavour='oci')
+    args = parser.parse_args(argv)
+
+    subprocess.check_call(('docker', 'image', 'rm', args.image))
+    load = _timed('docker', 'image', 'load', '--input', args.archive)
+
+    cmd = ('docker', 'run', '--rm', args.image, 'python3.13', '-c', 'pass')
+    _timed(*cmd)
+    runs = [_timed(*cmd) for _ in range(args.runs)]
+
+    image_size = int(
+        subprocess.check_output(
+            ('docker', 'image', 'inspect', '--format={{.Size}}', args.image),
+        ),
+    )
+    layers = _layers(args.archive)
+    # see oci/Dockerfile: ..., stdlib, interpreter
+    *base, stdlib, interpreter = (size for _, size in layers)
+    names = [*('base' for _ in base), 'stdlib', 'interpreter']
+
+    version = subprocess.check_output(
+        (
+            'docker', 'image', 'inspect', args.image,
+            f'--format={{{{index .Config.Labels "{VERSION_LABEL}"}}}}',
+        ),
+        text=True,
+    ).strip()
+    with open(os.path.join(os.path.dirname(__file__), 'buildinfo.py')) as f:
+        build = json.loads(
+            subprocess.check_output(
+                (
+                    'docker', 'run', '--rm', '-i', args.image,
+                    'python3.13', '-', '--package', f'python3.13={version}',
+                ),
+                stdin=f,
+            ),
+        )
+
+    previous = benchlib.history(
+        args.history, build['dist'], args.flavour, 'image', before=args.date,
+    )
+    if previous:
+        before = {
+            layer['digest']
+            for layer in previous[-1]['metadata'].get('layers', ())
+        }
+    else:
+        before = set()
+    layer_info = [
+        {
+            'name': name, 'digest': digest, 'size': size,
+            'shared': digest in before,
+        }
+        for name, (digest, size) in zip(names, layers)
+    ]
+
+    metrics = {
+        'archive_size': benchlib.Metric(os.stat(args.archive).st_size, 'B'),
+        'image_size': benchlib.Metric(image_size, 'B'),
+        'base_layers_size': benchlib.Metric(sum(base), 'B'),
+        'stdlib_layer_size': benchlib.Metric(stdlib, 'B'),
+        'interpreter_layer_size': benchlib.Metric(interpreter, 'B'),
+        'changed_layers_size': benchlib.Metric(
+            sum(layer['size'] for layer in layer_info if not layer['shared']),
+            'B',
+        ),
+        'load': benchlib.Metric(load, 's'),
+        'run': benchlib.Metric(
+            statistics.mean(runs), 's', 'lower', statistics.stdev(runs),
+        ),
+    }
+
+    benchlib.write_result(
+        args, 'image', metrics,
+        build=build,
+        metadata={
+            'image': args.image,
+            'runs': args.runs,
+            'layers': layer_info,
+            'previous': previous[-1]['date'] if previous else None,
+        },
+    )
+
+    rows = [('', '')]
+    for name, metric in metrics.items():
+        if metric.unit == 'B':
+            rows.append((name, f'{metric.value / 2**20:.1f} MiB'))
+        else:
+            rows.append((name, f'{metric.value * 1e3:.0f} ms'))
+    benchlib.step_summary(
+        f'## image {build["dist"]}\n\n{benchlib.format_table(rows)}',
+    )
+    if previous:
+        since = previous[-1]['date']
+        rows = [('layer', 'digest', 'size', f'shared with {since}')]
+        for layer in layer_info:
+            rows.append((
+                layer['name'], layer['digest'][:19],
+                f'{layer["size"] / 2**20:.1f} MiB',
+                'yes' if layer['shared'] else 'no',
+            ))
+        benchlib.step_summary(benchlib.format_table(rows))
+    return 0
+
+
+if __name__ == '__main__':
+    raise SystemExit(main())
@@ -0,0 +1,248 @@
+#!/usr/bin/env python3
+"""measure asyncio servers over loopback: requests per second and latency
+percentiles of an echo and an http-like keep-alive server, over tcp and
+unix sockets, written with streams and with protocols
+
+the http-like server runs its handler in a task per request, as frameworks
+do, once with the default task factory and once with
+``asyncio.eager_task_factory``.  the server and the concurrent client (one
+task per connection, each waiting for its response before the next
+request) are separate processes of the interpreter being measured.
+"""
+from __future__ import annotations
+
+import argparse
+import json
+import statistics
+import subprocess
+import tempfile
+from collections.abc import Sequence
+
+import benchlib
+
+SERVER = '''\
+import asyncio, sys
+
+transport, style, kind, factory, path = sys.argv[1:]
+BODY = b'{"hello": "world"}' * 32
+
+async def app(head):
+    return (
+        b'HTTP/1.1 200 OK\\r\\n'
+        b'Content-Type: application/json\\r\\n'
+        b'Content-Length: %d\\r\\n\\r\\n%s' % (len(BODY), BODY)
+    )
+
+async def echo_stream(reader, writer):
+    while data := await reader.read(1 << 16):
+        writer.write(data)
+        await writer.drain()
+    writer.close()
+
+async def http_stream(reader, writer):
+    try:
+        while True:
+            head = await reader.readuntil(b'\\r\\n\\r\\n')
+            writer.write(await asyncio.create_task(app(head)))
+            await writer.drain()
+    except asyncio.IncompleteReadError:
+        writer.close()
+
+class EchoProtocol(asyncio.Protocol):
+    def connection_made(self, transport):
+        self.transport = transport
+
+    def data_received(self, data):
+        self.transport.write(data)
+
+class HttpProtocol(asyncio.Protocol):
+    def connection_made(self, transport):
+        self.transport = transport
+        self.buf = b''
+
+    def data_received(self, data):
+        self.buf += data
+        while (end := self.buf.find(b'\\r\\n\\r\\n')) != -1:
+            head, self.buf = self.buf[:end + 4], self.buf[end + 4:]
+            task = asyncio.get_running_loop().create_task(app(head))
+            task.add_done_callback(self.respond)
+
+    def respond(self, task):
+        if not self.transport.is_closing():
+            self.transport.write(task.result())
+
+async def main():
+    loop = asyncio.get_running_loop()
+    if factory == 'eager':
+        loop.set_task_factory(asyncio.eager_task_factory)
+    if style == 'streams':
+        handler = echo_stream if kind == 'echo' else http_stream
+        if transport == 'tcp':
+            server = await asyncio.start_server(handler, '127.0.0.1', 0)
+        else:
+            server = await asyncio.start_unix_server(handler, path)
+    else:
+        protocol = EchoProtocol if kind == 'echo' else HttpProtocol
+        if transport == 'tcp':
+            server = await loop.create_server(protocol, '127.0.0.1', 0)
+        else:
+            server = await loop.create_unix_server(protocol, path)
+    if transport == 'tcp':
+        address = server.sockets[0].getsockname()[1]
+    else:
+        address = path
+    print(address, flush=True)
+    await server.serve_forever()
+
+asyncio.run(main())
+'''
+
+CLIENT = '''\
+import asyncio, json, sys, time
+
+transport, kind, address = sys.argv[1:4]
+concurrency, repeat, duration = map(float, sys.argv[4:])
+ECHO = b'x' * 1024
+REQUEST = b'GET / HTTP/1.1\\r\\nHost: localhost\\r\\n\\r\\n'
+
+def percentile(values, q):
+    values = sorted(values)
+    return values[min(len(values) - 1, int(q * len(values)))]
+
+async def connection(latencies, deadline):
+    if transport == 'tcp':
+        reader, writer = await asyncio.open_connection('127.0.0.1', address)
+    else:
+        reader, writer = await asyncio.open_unix_connection(address)
+    while (t0 := time.perf_counter()) < deadline:
+        if kind == 'echo':
+            writer.write(ECHO)
+            await reader.readexactly(len(ECHO))
+        else:
+            writer.write(REQUEST)
+            head = await reader.readuntil(b'\\r\\n\\r\\n')
+            length = int(head.lower().split(b'content-length: ')[1].split()[0])
+            await reader.readexactly(length)
+        latencies.append(time.perf_counter() - t0)
+    writer.close()
+    await writer.wait_closed()
+
+async def main():
+    rounds = []
+    for _ in range(int(repeat)):
+        latencies = []
+        t0 = time.perf_counter()
+        await asyncio.gather(*(
+            connection(latencies, t0 + duration)
+            for _ in range(int(concurrency))
+        ))
+        elapsed = time.perf_counter() - t0
+        rounds.append({
+            'rps': len(latencies) / elapsed,
+            'p50': percentile(latencies, .5),
+            'p99': percentile(latencies, .99),
+        })
+    print(json.dumps(rounds))
+
+asyncio.run(main())
+'''
+
+# the task factory only matters for the http-like server's handler tasks
+KINDS = {'echo': ('default',), 'http': ('default', 'eager')}
+CONFIGS = tuple(
+    (transport, style, kind, factory)
+    for transport in ('tcp', 'unix')
+    for style in ('streams', 'protocol')
+    for kind, factories in KINDS.items()
+    for factory in factories
+)
+
+
+def _config_name(transport: str, style: str, kind: str, factory: str) -> str:
+    name = f'{transport}/{style}/{kind}'
+    return name if factory == 'default' else f'{name}+{factory}'
+
+
+def _run(
+        args: argparse.Namespace,
+        transport: str,
+        style: str,
+        kind: str,
+        factory: str,
+        tmpdir: str,
+) -> list[dict[str, float]]:
+    server = subprocess.Popen(
+        (
+            args.python, '-c', SERVER,
+            transport, style, kind, factory, f'{tmpdir}/server.sock',
+        ),
+        stdout=subprocess.PIPE, text=True,
+    )
+    try:
+        assert server.stdout is not None
+        address = server.stdout.readline().strip()
+        out = subprocess.check_output((
+            args.python, '-c', CLIENT, transport, kind, address,
+            str(args.concurrency), str(args.repeat), str(args.duration),
+        ))
+    finally:
+        server.terminate()
+        server.wait()
+    return json.loads(out)
+
+
+def main(argv: Sequence[str] | None = None) -> int:
+    parser = argparse.ArgumentParser(
+        description=__doc__.splitlines()[0],
+        formatter_class=argparse.RawDescriptionHelpFormatter,
+        epilog='\n'.join(__doc__.splitlines()[1:]),
+    )
+    parser.add_argument('--python', default='python3.13')
+    parser.add_argument('--concurrency', type=int, default=64)
+    parser.add_argument('--repeat', type=int, default=3)
+    parser.add_argument('--duration', type=float, default=3, help='seconds')
+    benchlib.add_output_args(parser)
+    args = parser.parse_args(argv)
+
+    metrics = {}
+    rows = [('config', 'requests/s', 'p50', 'p99')]
+    for config in CONFIGS:
+        with tempfile.TemporaryDirectory() as tmpdir:
+            rounds = _run(args, *config, tmpdir)
+        name = _config_name(*config)
+
+        def metric(key: str, unit: str, better: str) -> benchlib.Metric:
+            values = [r[key] for r in rounds]
+            ret = metrics[f'{name}/{key}'] = benchlib.Metric(
+                statistics.mean(values), unit, better,
+                statistics.stdev(values) if len(values) > 1 else None,
+            )
+            return ret
+
+        rps = metric('rps', 'requests/s', 'higher')
+        p50 = metric('p50', 's', 'lower')
+        p99 = metric('p99', 's', 'lower')
+        rows.append((
+            name, f'{rps.value:,.0f}',
+            f'{p50.value * 1e6:,.0f} µs', f'{p99.value * 1e6:,.0f} µs',
+        ))
+
+    build = benchlib.build_info(args.python)
+    benchlib.write_result(
+        args, 'asyncio', metrics,
+        build=build,
+        metadata={
+            'concurrency': args.concurrency,
+            'repeat': args.repeat,
+            'duration': args.duration,
+        },
+    )
+    benchlib.step_summary(
+        f'## asyncio {build["dist"]} {args.flavour}\n\n'
+        f'{benchlib.format_table(rows)}',
+    )
+    return 0
+
+
+if __name__ == '__main__':
+    raise SystemExit(main())
@@ -0,0 +1,145 @@
+#!/usr/bin/env python3
+"""run pyperformance against several interpreters on the same machine,
+interleaved, to resolve differences smaller than the noise between runners
+
+each round runs every benchmark on every interpreter (in an order rotated
+from round to round, so drift during the job doesn't favour one of them);
+a benchmark's value is the mean of its rounds and its stdev is the stdev
+between rounds, so ``bench/compare.py`` compares interpreters against the
+noise of the machine they actually ran on.
+
+each run goes through ``bench/runner.py`` (pinned cpus, ``pyperf system
+tune``); run this with a python which has pyperformance installed, the
+interpreters are given as ``FLAVOUR=PYTHON``.
+"""
+from __future__ import annotations
+
+import argparse
+import os.path
+import statistics
+import subprocess
+import sys
+import tempfile
+import time
+from collections.abc import Sequence
+from typing import Any
+
+import benchlib
+
+# a cross-section of runner.BENCHMARKS: each run of one of these takes
+# about 30 s with pyperformance's defaults, 6 benchmarks x 3 rounds x 6
+# interpreters are about an hour (the job's timeout is 150 minutes, the
+# wall time is recorded with the results)
+BENCHMARKS = (
+    'chaos', 'deltablue', 'float', 'nbody', 'raytrace', 'richards',
+)
+
+
+def _run(
+        args: argparse.Namespace,
+        python: str,
+        benchmark: str,
+) -> dict[str, Any]:
+    """one run of bench/runner.py (pinned and tuned), without reruns"""
+    runner = os.path.join(os.path.dirname(__file__), 'runner.py')
+    with tempfile.TemporaryDirectory() as tmpdir:
+        subprocess.check_call((
+            sys.executable, runner,
+            f'--python={python}',
+            f'--benchmarks={benchmark}',
+            '--name=paired',
+            '--reruns=0',
+            f'--history={tmpdir}',
+            f'--output-dir={tmpdir}',
+            f'--date={args.date}',
+        ))
+        result, = benchlib.iter_results(tmpdir)
+    return result
+
+
+def main(argv: Sequence[str] | None = None) -> int:
+    parser = argparse.ArgumentParser(
+        description=__doc__.splitlines()[0],
+        formatter_class=argparse.RawDescriptionHelpFormatter,
+        epilog='\n'.join(__doc__.splitlines()[1:]),
+    )
+    parser.add_argument(
+        'pythons', nargs='+', metavar='FLAVOUR=PYTHON',
+        help='interpreters to compare',
+    )
+    parser.add_argument(
+        '--benchmarks', default=','.join(BENCHMARKS),
+        help='comma separated pyperformance benchmarks '
+             '(default: %(default)s)',
+    )
+    parser.add_argument('--rounds', type=int, default=3)
+    parser.add_argument(
+        '--name', default='pyperformance-paired',
+        help='name to store the results under (default: %(default)s)',
+    )
+    benchlib.add_output_args(parser)
+    args = parser.parse_args(argv)
+
+    pythons = dict(spec.split('=', 1) for spec in args.pythons)
+    flavours = list(pythons)
+    benchmarks = args.benchmarks.split(',')
+
+    # flavour -> benchmark -> mean of each round
+    rounds: dict[str, dict[str, list[float]]] = {f: {} for f in flavours}
+    harness = None
+    t0 = time.monotonic()
+    for i in range(args.rounds):
+        for benchmark in benchmarks:
+            order = flavours[i % len(flavours):] + flavours[:i % len(flavours)]
+            for flavour in order:
+                result = _run(args, pythons[flavour], benchmark)
+                harness = result['metadata']['harness']
+                for name, metric in result['metrics'].items():
+                    rounds[flavour].setdefault(name, []).append(
+                        metric['value'],
+                    )
+    elapsed = time.monotonic() - t0
+
+    rows = [('benchmark', *flavours)]
+    names = sorted({name for by_name in rounds.values() for name in by_name})
+    for flavour, by_name in rounds.items():
+        build = benchlib.build_info(pythons[flavour])
+        # only benchmarks which ran in every round
+        complete = {k: v for k, v in by_name.items() if len(v) == args.rounds}
+        benchlib.write_result(
+            argparse.Namespace(**{**vars(args), 'flavour': flavour}),
+            args.name,
+            {
+                name: benchlib.Metric(
+                    statistics.mean(values), 's', 'lower',
+                    statistics.stdev(values) if len(values) > 1 else None,
+                )
+                for name, values in complete.items()
+            },
+            build=build,
+            metadata={
+                'rounds': args.rounds,
+                'paired_with': [f for f in flavours if f != flavour],
+                'harness': harness,
+                'elapsed': elapsed,
+            },
+        )
+    for name in names:
+        cells = []
+        for flavour in flavours:
+            values = rounds[flavour].get(name)
+            if values and len(values) == args.rounds:
+                cells.append(f'{statistics.mean(values) * 1e3:.3f} ms')
+            else:
+                cells.append('-')
+        rows.append((name, *cells))
+    benchlib.step_summary(
+        f'## {args.name} {build["dist"]} ({args.rounds} rounds, '
+        f'{elapsed / 60:.0f} minutes)\n\n'
+        f'{benchlib.format_table(rows)}',
+    )
+    return 0
+
+
+if __name__ == '__main__':
+    raise SystemExit(main())
@@ -0,0 +1,214 @@
+#!/usr/bin/env python3
+"""measure process pools: startup latency of ``multiprocessing.Pool`` and
+``concurrent.futures.ProcessPoolExecutor`` per start method (fork,
+forkserver, spawn), their task dispatch throughput with small and large
+pickled payloads, and large transfers through ``shared_memory`` compared
+with pickling
+
+startup is the time from creating the pool until it returned a first batch
+of one no-op task per worker; ``startup/<api>/<method>/cold`` is the first
+pool of each, which for forkserver includes starting the server (it's
+stopped before), and ``startup/<api>/<method>`` the best of the pools after
+it, for forkserver on a running server.  dispatch uses each api's default
+chunksize, and dispatch and transfers use the default start method, so a
+change of default upstream shows up too.
+"""
+from __future__ import annotations
+
+import argparse
+import json
+import os.path
+import subprocess
+import tempfile
+from collections.abc import Sequence
+
+import benchlib
+
+# run from a file: spawn and forkserver workers re-import it
+WORKLOAD = '''\
+import json, multiprocessing, sys, time
+from concurrent.futures import ProcessPoolExecutor
+from multiprocessing import forkserver, shared_memory
+
+# size, tasks per measurement (divisor of the tasks argument)
+PAYLOADS = {'small': (100, 1), 'large': (2**20, 100)}
+
+def noop(x):
+    return x
+
+def echo(data):
+    return len(data)
+
+def attach(name, size):
+    shm = shared_memory.SharedMemory(name, track=False)
+    try:
+        return len(bytes(shm.buf[:size]))
+    finally:
+        shm.close()
+
+def main():
+    workers, tasks, transfer, repeat = map(int, sys.argv[1:])
+
+    def best(fn):
+        ret = float('inf')
+        for _ in range(repeat):
+            t0 = time.perf_counter()
+            fn()
+            ret = min(ret, time.perf_counter() - t0)
+        return ret
+
+    def startup(method, make, run):
+        """(the first, the best of the repeats after it)"""
+        # the forkserver outlives the pools: stopped, the first pool starts
+        # it again, as the first pool of a program does
+        if method == 'forkserver':
+            forkserver._forkserver._stop()
+        ret = []
+        for _ in range(repeat + 1):
+            t0 = time.perf_counter()
+            pool = make()
+            run(pool, noop, range(workers))
+            ret.append(time.perf_counter() - t0)
+            with pool:  # shutdown isn't part of startup
+                pass
+        return ret[0], min(ret[1:])
+
+    def pool_map(pool, fn, it):
+        return pool.map(fn, it, chunksize=1)
+
+    def executor_map(pool, fn, it):
+        return list(pool.map(fn, it))
+
+    results = {}
+    for method in multiprocessing.get_all_start_methods():
+        ctx = multiprocessing.get_context(method)
+        for api, make, run in (
+                ('pool', lambda: ctx.Pool(workers), pool_map),
+                (
+                    'executor',
+                    lambda: ProcessPoolExecutor(workers, mp_context=ctx),
+                    executor_map,
+                ),
+        ):
+            (
+                results[f'startup/{api}/{method}/cold'],
+                results[f'startup/{api}/{method}'],
+            ) = startup(method, make, run)
+
+    ctx = multiprocessing.get_context()
+    for api, make, run in (
+            ('pool', lambda: ctx.Pool(workers), lambda p, f, it: p.map(f, it)),
+            (
+                'executor',
+                lambda: ProcessPoolExecutor(workers, mp_context=ctx),
+                executor_map,
+            ),
+    ):
+        with make() as pool:
+            run(pool, noop, range(workers))
+            for name, (size, divisor) in PAYLOADS.items():
+                n = max(tasks // divisor, workers)
+                args = [bytes(size)] * n
+                results[f'dispatch/{api}/{name}'] = n / best(
+                    lambda: run(pool, echo, args),
+                )
+
+    payload = bytes(transfer)
+    shm = shared_memory.SharedMemory(create=True, size=transfer)
+    try:
+        with ctx.Pool(1) as pool:
+            def via_shared_memory():
+                shm.buf[:transfer] = payload
+                pool.apply(attach, (shm.name, transfer))
+            results['transfer/shared_memory'] = transfer / best(
+                via_shared_memory,
+            )
+            results['transfer/pickle'] = transfer / best(
+                lambda: pool.apply(echo, (payload,)),
+            )
+    finally:
+        shm.close()
+        shm.unlink()
+
+    print(json.dumps({'default': ctx.get_start_method(), **results}))
+
+if __name__ == '__main__':
+    main()
+'''
+
+
+def _unit(name: str) -> tuple[str, str]:
+    if name.startswith('startup/'):
+        return 's', 'lower'
+    elif name.startswith('dispatch/'):
+        return 'tasks/s', 'higher'
+    else:
+        return 'B/s', 'higher'
+
+
+def main(argv: Sequence[str] | None = None) -> int:
+    parser = argparse.ArgumentParser(
+        description=__doc__.splitlines()[0],
+        formatter_class=argparse.RawDescriptionHelpFormatter,
+        epilog='\n'.join(__doc__.splitlines()[1:]),
+    )
+    parser.add_argument('--python', default='python3.13')
+    parser.add_argument('--workers', type=int, default=os.cpu_count() or 1)
+    parser.add_argument(
+        '--tasks', type=int, default=20_000,
+        help='small payload tasks per dispatch measurement (large payloads: '
+             'a hundredth of it)',
+    )
+    parser.add_argument(
+        '--transfer', type=int, default=64 * 2**20, help='bytes',
+    )
+    parser.add_argument('--repeat', type=int, default=5)
+    benchlib.add_output_args(parser)
+    args = parser.parse_args(argv)
+
+    with tempfile.TemporaryDirectory() as tmpdir:
+        script = os.path.join(tmpdir, 'procpool_workload.py')
+        with open(script, 'w') as f:
+            f.write(WORKLOAD)
+        measured = json.loads(
+            subprocess.check_output((
+                args.python, script, str(args.workers), str(args.tasks),
+                str(args.transfer), str(args.repeat),
+            )),
+        )
+    default = measured.pop('default')
+
+    metrics = {}
+    rows = [('', '')]
+    for name, value in measured.items():
+        unit, better = _unit(name)
+        metrics[name] = benchlib.Metric(value, unit, better)
+        if unit == 's':
+            rows.append((name, f'{value * 1e3:,.1f} ms'))
+        elif unit == 'B/s':
+            rows.append((name, f'{value / 2**20:,.0f} MiB/s'))
+        else:
+            rows.append((name, f'{value:,.0f} {unit}'))
+
+    build = benchlib.build_info(args.python)
+    benchlib.write_result(
+        args, 'procpool', metrics,
+        build=build,
+        metadata={
+            'default_start_method': default,
+            'workers': args.workers,
+            'tasks': args.tasks,
+            'transfer': args.transfer,
+            'repeat': args.repeat,
+        },
+    )
+    benchlib.step_summary(
+        f'## procpool {build["dist"]} {args.flavour} '
+        f'(default start method: {default})\n\n'
+        f'{benchlib.format_table(rows)}',
+    )
+    return 0
+
+
+if __name__ == '__main__':
+    raise SystemExit(main())
@@ -0,0 +1,264 @@
+#!/usr/bin/env python3
+"""render the benchmark history as a single self-contained html page"""
+from __future__ import annotations
+
+import argparse
+import collections
+import html
+import math
+from collections.abc import Sequence
+from typing import Any
+from typing import NamedTuple
+
+import benchlib
+
+COMPARE = 'https://github.com/python/cpython/compare/{}...{}'
+COLORS = (
+    '#1f77b4', '#ff7f0e', '#2ca02c', '#d62728', '#9467bd', '#8c564b',
+    '#e377c2', '#7f7f7f', '#bcbd22', '#17becf',
+)
+WIDTH, HEIGHT, PAD = 640, 180, 40
+
+STYLE = '''\
+body { font-family: sans-serif; margin: 2em; color: #222; }
+h2 { border-bottom: 1px solid #ccc; }
+.charts { display: flex; flex-wrap: wrap; gap: 1em; }
+figure { margin: 0; }
+figcaption { font-size: .9em; font-weight: bold; }
+svg text { font-size: 10px; }
+table { border-collapse: collapse; margin: 1em 0; }
+td, th { border: 1px solid #ccc; padding: .2em .5em; font-size: .9em; }
+.worse { color: #b00; }
+.better { color: #070; }
+'''
+
+
+class Point(NamedTuple):
+    date: str
+    value: float
+    stdev: float | None
+    build: dict[str, Any]
+
+
+Series = dict[str, list[Point]]  # keyed by "dist flavour"
+
+
+def _svg(series: Series, unit: str) -> str:
+    dates = sorted({p.date for points in series.values() for p in points})
+    values = [p.value for points in series.values() for p in points]
+    if not dates:
+        return ''
+    lo, hi = min(values), max(values)
+    if lo == hi:
+        lo, hi = lo * .95, hi * 1.05 or 1
+    span = hi - lo
+
+    def x(date: str) -> float:
+        if len(dates) == 1:
+            return WIDTH / 2
+        return PAD + dates.index(date) * (WIDTH - 2 * PAD) / (len(dates) - 1)
+
+    def y(value: float) -> float:
+        return HEIGHT - PAD / 2 - (value - lo) / span * (HEIGHT - PAD)
+
+    parts = [
+        f'<svg width="{WIDTH}" height="{HEIGHT + 20 * len(series)}" '
+        f'xmlns="http://www.w3.org/2000/svg">',
+        f'<text x="0" y="10">{_fmt(hi, unit)}</text>',
+        f'<text x="0" y="{HEIGHT - PAD / 2}">{_fmt(lo, unit)}</text>',
+        f'<text x="{PAD}" y="{HEIGHT}">{dates[0]}</text>',
+        f'<text x="{WIDTH - PAD}" y="{HEIGHT}" text-anchor="end">'
+        f'{dates[-1]}</text>',
+    ]
+    for i, (key, points) in enumerate(sorted(series.items())):
+        color = COLORS[i % len(COLORS)]
+        coords = ' '.join(f'{x(p.date):.1f},{y(p.value):.1f}' for p in points)
+        parts.append(
+            f'<polyline fill="none" stroke="{color}" points="{coords}"/>',
+        )
+        for p in points:
+            parts.append(
+                f'<circle cx="{x(p.date):.1f}" cy="{y(p.value):.1f}" r="2" '
+                f'fill="{color}"><title>{html.escape(key)} {p.date}: '
+                f'{_fmt(p.value, unit)} ({p.build.get("build_id")})'
+                f'</title></circle>',
+            )
+        parts.append(
+            f'<text x="{PAD}" y="{HEIGHT + 15 + 20 * i}" fill="{color}">'
+            f'{html.escape(key)}</text>',
+        )
+    parts.append('</svg>')
+    return ''.join(parts)
+
+
+def _fmt(value: float, unit: str) -> str:
+    if unit == 's':
+        for scale, name in ((1, 's'), (1e-3, 'ms'), (1e-6, 'us')):
+            if abs(value) >= scale:
+                return f'{value / scale:.3g} {name}'
+        return f'{value / 1e-9:.3g} ns'
+    return f'{value:.4g} {unit}'.strip()
+
+
+def _link(before: Point, after: Point) -> str:
+    old, new = before.build.get('git_sha'), after.build.get('git_sha')
+    if benchlib.same_commit(old, new):
+        return f'{old[:10]} (same commit)'
+    elif old and new:
+        url = html.escape(COMPARE.format(old, new))
+        return f'<a href="{url}">{old[:10]}...{new[:10]}</a>'
+    else:
+        versions = (
+            before.build.get('package_version'),
+            after.build.get('package_version'),
+        )
+        return html.escape(' ... '.join(str(v) for v in versions))
+
+
+def _change_points(
+        series: Series,
+        threshold: float,
+) -> list[tuple[str, Point, Point, float]]:
+    ret = []
+    for key, points in sorted(series.items()):
+        for before, after in zip(points, points[1:]):
+            if not before.value:
+                continue
+            change = after.value / before.value - 1
+            noise = sum(
+                p.stdev / p.value for p in (before, after) if p.stdev
+            )
+            if abs(change) > max(threshold, 2 * noise):
+                ret.append((key, before, after, change))
+    return ret
+
+
+def _change_table(
+        changes: list[tuple[str, Point, Point, float]],
+        better: str,
+) -> str:
+    if not changes:
+        return ''
+    rows = ['<table><tr><th></th><th>from</th><th>to</th><th>change</th>'
+            '<th>upstream</th></tr>']
+    for key, before, after, change in changes:
+        worse = (change > 0) == (better == 'lower')
+        rows.append(
+            f'<tr><td>{html.escape(key)}</td><td>{before.date}</td>'
+            f'<td>{after.date}</td>'
+            f'<td class="{"worse" if worse else "better"}">{change:+.1%}</td>'
+            f'<td>{_link(before, after)}</td></tr>',
+        )
+    rows.append('</table>')
+    return ''.join(rows)
+
+
+def _geomean(
+        metrics: dict[str, Series],
+        better: dict[str, str],
+) -> Series:
+    """per night geometric mean of each metric relative to its first night
+
+    higher-is-better metrics are inverted so that above 1 is always worse
+    """
+    ret: Series = {}
+    keys = {key for series in metrics.values() for key in series}
+    for key in sorted(keys):
+        by_date: dict[str, list[float]] = collections.defaultdict(list)
+        builds = {}
+        for name, series in metrics.items():
+            points = series.get(key, [])
+            if not points:
+                continue
+            first = points[0].value
+            for p in points:
+                if first <= 0 or p.value <= 0:
+                    continue
+                ratio = p.value / first
+                if better[name] == 'higher':
+                    ratio = 1 / ratio
+                by_date[p.date].append(math.log(ratio))
+                builds[p.date] = p.build
+        ret[key] = [
+            Point(date, math.exp(sum(logs) / len(logs)), None, builds[date])
+            for date, logs in sorted(by_date.items())
+        ]
+    return ret
+
+
+def render(results: list[dict[str, Any]], threshold: float) -> str:
+    # benchmark -> metric -> "dist flavour" -> points
+    data: dict[str, dict[str, Series]] = collections.defaultdict(
+        lambda: collections.defaultdict(lambda: collections.defaultdict(list)),
+    )
+    units: dict[tuple[str, str], tuple[str, str]] = {}
+    for result in sorted(results, key=lambda r: r['date']):
+        key = f'{result["dist"]} {result["flavour"]}'
+        for name, metric in result['metrics'].items():
+            data[result['benchmark']][name][key].append(
+                Point(
+                    result['date'], metric['value'], metric.get('stdev'),
+                    result['build'],
+                ),
+            )
+            units[result['benchmark'], name] = metric['unit'], metric['better']
+
+    body = ['<h1>python3.13 nightly benchmarks</h1><ul>']
+    for benchmark in sorted(data):
+        body.append(f'<li><a href="#{benchmark}">{benchmark}</a></li>')
+    body.append('</ul>')
+
+    for benchmark, metrics in sorted(data.items()):
+        better = {name: units[benchmark, name][1] for name in metrics}
+        body.append(f'<h2 id="{benchmark}">{benchmark}</h2>')
+
+        if len(metrics) > 1:
+            geomean = _geomean(metrics, better)
+            body.append(
+                '<figure><figcaption>geometric mean relative to first night '
+                '(lower is better)</figcaption>',
+            )
+            body.append(_svg(geomean, 'x'))
+            body.append(
+                _change_table(_change_points(geomean, threshold), 'lower'),
+            )
+            body.append('</figure>')
+
+        body.append('<div class="charts">')
+        for name, series in sorted(metrics.items()):
+            unit, direction = units[benchmark, name]
+            changes = _change_points(series, threshold)
+            body.append(
+                f'<figure><figcaption>{html.escape(name)} ({direction} is '
+                f'better)</figcaption>{_svg(series, unit)}'
+                f'{_change_table(changes, direction)}</figure>',
+            )
+        body.append('</div>')
+
+    return (
+        f'<!doctype html><html><head><meta charset="utf-8">'
+        f'<title>python3.13 nightly benchmarks</title>'
+        f'<style>{STYLE}</style></head><body>{"".join(body)}</body></html>\n'
+    )
+
+
+def main(argv: Sequence[str] | None = None) -> int:
+    parser = argparse.ArgumentParser(description=__doc__)
+    parser.add_argument('results', help='root of the results tree')
+    parser.add_argument('--output', default='index.html')
+    parser.add_argument(
+        '--threshold', type=float, default=.05,
+        help='smallest night to night change to highlight '
+             '(default: %(default)s)',
+    )
+    args = parser.parse_args(argv)
+
+    results = list(benchlib.iter_results(args.results))
+    with open(args.output, 'w') as f:
+        f.write(render(results, args.threshold))
+    print(f'wrote {args.output} ({len(results)} results)')
+    return 0
+
+
+if __name__ == '__main__':
+    raise SystemExit(main())
@@ -0,0 +1,306 @@
+#!/usr/bin/env python3
+"""run pyperformance against an interpreter in a controlled environment
+
+- the benchmark workers are pinned to a fixed cpu set (all but cpu 0 when
+  there is more than one, cpu 0 takes most interrupts)
+- ``pyperf system tune`` is applied (performance governor, turbo off, ...)
+  as far as the host allows, the state of the knobs which could not be set
+  is recorded alongside the results
+- each benchmark whose relative standard deviation is above
+  ``--rsd-threshold`` is rerun, up to ``--reruns`` times, until a run is
+  below it.  the last run is kept either way (picking the quietest would
+  bias the mean, the previous night's value had no such pick), and a
+  slowdown against the previous night is only reported as a regression
+  when that run isn't noisy
+
+run this with a python which has pyperformance installed, the interpreter
+being measured is ``--python``.
+"""
+from __future__ import annotations
+
+import argparse
+import importlib.metadata
+import json
+import os.path
+import statistics
+import subprocess
+import sys
+import tempfile
+from collections.abc import Sequence
+from typing import Any
+from typing import NamedTuple
+
+import benchlib
+
+# benchmarks which only need pyperf, anything with c-extension requirements
+# is likely not to build against a nightly
+BENCHMARKS = (
+    'async_tree', 'chaos', 'comprehensions', 'coroutines', 'deepcopy',
+    'deltablue', 'fannkuch', 'float', 'generators', 'go', 'hexiom',
+    'json_dumps', 'json_loads', 'logging', 'nbody', 'nqueens', 'pathlib',
+    'pickle', 'pidigits', 'pyflate', 'raytrace', 'regex_compile', 'regex_dna',
+    'regex_effbot', 'regex_v8', 'richards', 'scimark', 'spectral_norm',
+    'sqlite_synth', 'telco', 'unpack_sequence', 'unpickle', 'xml_etree',
+)
+
+SYSFS = {
+    'aslr': '/proc/sys/kernel/randomize_va_space',
+    'intel_pstate_no_turbo': '/sys/devices/system/cpu/intel_pstate/no_turbo',
+    'cpufreq_boost': '/sys/devices/system/cpu/cpufreq/boost',
+}
+GOVERNOR = '/sys/devices/system/cpu/cpu{}/cpufreq/scaling_governor'
+
+
+class Stats(NamedTuple):
+    mean: float
+    stdev: float
+    loops: int
+    warmups: int
+    values: int
+
+    @property
+    def rsd(self) -> float:
+        return self.stdev / self.mean if self.mean else 0.
+
+    def calibration(self, reruns: int) -> dict[str, Any]:
+        return {**self._asdict(), 'rsd': self.rsd, 'reruns': reruns}
+
+
+def _read(path: str) -> str | None:
+    try:
+        with open(path) as f:
+            return f.read().strip()
+    except OSError:
+        return None
+
+
+def _environment(cpus: list[int]) -> dict[str, Any]:
+    ret: dict[str, Any] = {k: _read(v) for k, v in SYSFS.items()}
+    ret['governors'] = {cpu: _read(GOVERNOR.format(cpu)) for cpu in cpus}
+    ret['cpus'] = ','.join(str(cpu) for cpu in cpus)
+    return ret
+
+
+def _tune(cpus: list[int]) -> dict[str, Any]:
+    cmd = (
+        sys.executable, '-m', 'pyperf', 'system', 'tune',
+        f'--affinity={",".join(str(cpu) for cpu in cpus)}',
+    )
+    proc = subprocess.run(cmd, capture_output=True, text=True)
+    # not fatal: in a container most of the knobs are read only
+    return {
+        'before': _environment(cpus),
+        'tune_returncode': proc.returncode,
+        'tune_output': (proc.stdout + proc.stderr).strip(),
+    }
+
+
+def _pick_cpus(spec: str) -> list[int]:
+    if spec != 'auto':
+        return sorted({int(cpu) for cpu in spec.split(',')})
+    available = sorted(os.sched_getaffinity(0))
+    return available[1:] if len(available) > 1 else available
+
+
+def _stats(benchmark: dict[str, Any]) -> Stats:
+    common = benchmark.get('metadata', {})
+    values: list[float] = []
+    warmups = []
+    loops = []
+    for run in benchmark['runs']:
+        if not run.get('values'):  # calibration run
+            continue
+        values.extend(run['values'])
+        warmups.append(len(run.get('warmups', ())))
+        loops.append(run.get('metadata', {}).get('loops', common.get('loops')))
+    return Stats(
+        mean=statistics.mean(values),
+        stdev=statistics.stdev(values) if len(values) > 1 else 0.,
+        loops=max((n for n in loops if n is not None), default=1),
+        warmups=max(warmups, default=0),
+        values=len(values),
+    )
+
+
+def _run(
+        args: argparse.Namespace,
+        cpus: list[int],
+        benchmark: str,
+) -> dict[str, Stats]:
+    env = dict(os.environ)
+    env.update(kv.split('=', 1) for kv in args.env)
+    inherit = ','.join(kv.split('=', 1)[0] for kv in args.env)
+
+    with tempfile.TemporaryDirectory() as tmpdir:
+        output = os.path.join(tmpdir, 'pyperf.json')
+        cmd = [
+            sys.executable, '-m', 'pyperformance', 'run',
+            f'--python={args.python}',
+            f'--benchmarks={benchmark}',
+            f'--affinity={",".join(str(cpu) for cpu in cpus)}',
+            f'--output={output}',
+        ]
+        if inherit:
+            cmd.append(f'--inherit-environ={inherit}')
+        if subprocess.call(cmd, env=env):
+            print(f'{benchmark}: failed, skipping', file=sys.stderr)
+            return {}
+
+        with open(output) as f:
+            suite = json.load(f)
+
+    return {
+        bench['metadata']['name']: _stats(bench)
+        for bench in suite['benchmarks']
+    }
+
+
+def _harness() -> dict[str, str]:
+    """versions of pyperformance (and with it the benchmarks) and pyperf"""
+    return {
+        name: importlib.metadata.version(name)
+        for name in ('pyperformance', 'pyperf')
+    }
+
+
+def _compare(
+        args: argparse.Namespace,
+        build: dict[str, Any],
+        harness: dict[str, str],
+        stats: dict[str, Stats],
+) -> list[dict[str, Any]]:
+    previous = benchlib.history(
+        args.history, build['dist'], args.flavour, args.name,
+        before=args.date,
+    )
+    if not previous:
+        return []
+    baseline = previous[-1]
+
+    ret = []
+    for name, st in sorted(stats.items()):
+        if name not in baseline['metrics']:
+            continue
+        before = baseline['metrics'][name]['value']
+        change = st.mean / before - 1
+        if change <= args.regression_threshold:
+            continue
+        ret.append({
+            'benchmark': name,
+            'baseline_date': baseline['date'],
+            'baseline_build': baseline['build']['build_id'],
+            'change': change,
+            'rsd': st.rsd,
+            # a noisy slowdown is reported, but not as a regression
+            'noisy': st.rsd > args.rsd_threshold,
+            # and neither is one across a harness / benchmark upgrade
+            'harness_changed': (
+                baseline['metadata'].get('harness') != harness
+            ),
+        })
+    return ret
+
+
+def main(argv: Sequence[str] | None = None) -> int:
+    parser = argparse.ArgumentParser(
+        description=__doc__.splitlines()[0],
+        formatter_class=argparse.RawDescriptionHelpFormatter,
+        epilog='\n'.join(__doc__.splitlines()[1:]),
+    )
+    parser.add_argument('--python', default='python3.13')
+    parser.add_argument(
+        '--benchmarks', default=','.join(BENCHMARKS),
+        help='comma separated pyperformance benchmarks (default: all which '
+             'only depend on pyperf)',
+    )
+    parser.add_argument(
+        '--name', default='pyperformance',
+        help='name to store the results under (default: %(default)s)',
+    )
+    parser.add_argument(
+        '--cpus', default='auto',
+        help='comma separated cpus to pin the workers to '
+             '(default: %(default)s)',
+    )
+    parser.add_argument(
+        '--env', action='append', default=[], metavar='NAME=VALUE',
+        help='set (and pass through to the benchmark workers) an environment '
+             'variable, may be repeated',
+    )
+    parser.add_argument('--rsd-threshold', type=float, default=.02)
+    parser.add_argument('--reruns', type=int, default=3)
+    parser.add_argument('--regression-threshold', type=float, default=.03)
+    parser.add_argument(
+        '--history', default='history',
+        help='previous results to compare against (default: %(default)s)',
+    )
+    benchlib.add_output_args(parser)
+    args = parser.parse_args(argv)
+
+    build = benchlib.build_info(args.python)
+
+    cpus = _pick_cpus(args.cpus)
+    environment = _tune(cpus)
+    environment['after'] = _environment(cpus)
+
+    stats: dict[str, Stats] = {}
+    reruns: dict[str, int] = {}
+    for benchmark in args.benchmarks.split(','):
+        results = _run(args, cpus, benchmark)
+        for _ in range(args.reruns):
+            if all(st.rsd <= args.rsd_threshold for st in results.values()):
+                break
+            for name, st in _run(args, cpus, benchmark).items():
+                reruns[name] = reruns.get(name, 0) + 1
+                results[name] = st
+        stats.update(results)
+
+    harness = _harness()
+    regressions = _compare(args, build, harness, stats)
+
+    benchlib.write_result(
+        args, args.name,
+        {
+            name: benchlib.Metric(st.mean, 's', 'lower', st.stdev)
+            for name, st in stats.items()
+        },
+        build=build,
+        metadata={
+            'environment': environment,
+            'env': args.env,
+            'rsd_threshold': args.rsd_threshold,
+            'calibration': {
+                name: st.calibration(reruns.get(name, 0))
+                for name, st in stats.items()
+            },
+            'regressions': regressions,
+            'harness': harness,
+        },
+    )
+
+    rows = [('benchmark', 'mean', 'rsd', 'loops', 'values', 'reruns')]
+    for name, st in sorted(stats.items()):
+        rows.append((
+            name, f'{st.mean * 1e3:.3f} ms', f'{st.rsd:.1%}', str(st.loops),
+            str(st.values), str(reruns.get(name, 0)),
+        ))
+    benchlib.step_summary(
+        f'## {args.name} {build["dist"]} {args.flavour} '
+        f'({build["build_id"]})\n\n{benchlib.format_table(rows)}',
+    )
+    if regressions:
+        rows = [('benchmark', 'change', 'rsd', 'since')]
+        for reg in regressions:
+            noisy = ' (noisy)' if reg['noisy'] else ''
+            if reg['harness_changed']:
+                noisy += ' (new pyperformance / pyperf)'
+            rows.append((
+                reg['benchmark'], f'{reg["change"]:+.1%}{noisy}',
+                f'{reg["rsd"]:.1%}', reg['baseline_date'],
+            ))
+        benchlib.step_summary(f'### slower\n\n{benchlib.format_table(rows)}')
+    return 0
+
+
+if __name__ == '__main__':
+    raise SystemExit(main())
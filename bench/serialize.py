@@ -0,0 +1,216 @@
+#!/usr/bin/env python3
+"""measure serialization at production payload sizes (100 B to 100 MiB):
+encode / decode throughput and the peak memory on top of the payload for
+``json``, ``pickle`` (protocol 5, large buffers out-of-band), ``marshal``
+and ``struct``
+
+the payload shapes are a tree of nested dicts, a wide list of records and
+one large buffer.  throughput is in bytes of the encoded form, including
+pickle's out-of-band buffers (which are not copied, so ``pickle/bytes``
+measures the zero-copy path).  peak memory is the growth of the peak rss
+during one call, so memory the allocator had already mapped doesn't count.
+"""
+from __future__ import annotations
+
+import argparse
+import json
+import subprocess
+from collections.abc import Sequence
+
+import benchlib
+
+SIZES = {
+    '100B': 100, '10KiB': 10 * 2**10, '1MiB': 2**20, '100MiB': 100 * 2**20,
+}
+FORMATS = {
+    'json': ('nested', 'records'),
+    'pickle': ('nested', 'records', 'bytes'),
+    'marshal': ('nested', 'records', 'bytes'),
+    'struct': ('records',),
+}
+
+WORKLOAD = '''\
+import json, marshal, pickle, random, struct, sys, time
+
+sizes, formats = json.loads(sys.argv[1]), json.loads(sys.argv[2])
+repeat, min_time = int(sys.argv[3]), float(sys.argv[4])
+rng = random.Random(0)
+
+def status(field):
+    with open('/proc/self/status') as f:
+        for line in f:
+            if line.startswith(f'{field}:'):
+                return int(line.split()[1]) * 1024
+
+def reset_peak():
+    with open('/proc/self/clear_refs', 'w') as f:
+        f.write('5')
+
+def record(i):
+    return {
+        'id': i, 'name': f'user-{i}', 'email': f'user-{i}@example.com',
+        'score': rng.random(), 'active': i % 3 == 0, 'tags': ['a', 'b'],
+    }
+
+# approximate encoded size per node / record
+def nested(size):
+    nodes = [{'id': 0, 'name': 'node-0', 'children': []}]
+    for i in range(1, max(size // 48, 1)):
+        node = {'id': i, 'name': f'node-{i}', 'children': []}
+        nodes[(i - 1) // 8]['children'].append(node)
+        nodes.append(node)
+    return nodes[0]
+
+def records(size):
+    return [record(i) for i in range(max(size // 128, 1))]
+
+def buffer(size):
+    return bytearray(rng.randbytes(size))
+
+RECORD = struct.Struct('<qd32s?')
+
+CODECS = {
+    'json': (
+        lambda obj: json.dumps(obj).encode(),
+        lambda data: json.loads(data),
+    ),
+    'marshal': (
+        lambda obj: marshal.dumps(obj),
+        lambda data: marshal.loads(data),
+    ),
+}
+
+def pickle_codec(shape):
+    def dumps(obj):
+        buffers = []
+        if shape == 'bytes':
+            obj = pickle.PickleBuffer(obj)
+        data = pickle.dumps(obj, protocol=5, buffer_callback=buffers.append)
+        return data, buffers
+    def loads(encoded):
+        data, buffers = encoded
+        return pickle.loads(data, buffers=buffers)
+    return dumps, loads
+
+def struct_codec():
+    def dumps(obj):
+        return b''.join(
+            RECORD.pack(r['id'], r['score'], r['email'].encode(), r['active'])
+            for r in obj
+        )
+    def loads(data):
+        return list(RECORD.iter_unpack(data))
+    return dumps, loads
+
+def encoded_size(encoded):
+    if isinstance(encoded, tuple):  # pickle: data and out-of-band buffers
+        data, buffers = encoded
+        return len(data) + sum(memoryview(b).nbytes for b in buffers)
+    return len(encoded)
+
+def measure(fn, arg):
+    """seconds per call (best of repeat) and peak memory of one call"""
+    rss = status('VmRSS')
+    reset_peak()
+    ret = fn(arg)
+    peak = status('VmHWM') - rss
+    best = float('inf')
+    for _ in range(repeat):
+        n = 0
+        t0 = time.perf_counter()
+        while time.perf_counter() - t0 < min_time or not n:
+            fn(arg)
+            n += 1
+        best = min(best, (time.perf_counter() - t0) / n)
+    return ret, best, peak
+
+results = {}
+for fmt, shapes in formats.items():
+    for shape in shapes:
+        if fmt == 'pickle':
+            dumps, loads = pickle_codec(shape)
+        elif fmt == 'struct':
+            dumps, loads = struct_codec()
+        else:
+            dumps, loads = CODECS[fmt]
+        for size_name, size in sizes.items():
+            payload = {
+                'nested': nested, 'records': records, 'bytes': buffer,
+            }[shape](size)
+            encoded, dumps_time, dumps_peak = measure(dumps, payload)
+            _, loads_time, loads_peak = measure(loads, encoded)
+            n = encoded_size(encoded)
+            results[f'{fmt}/{shape}/{size_name}'] = {
+                'size': n,
+                'dumps': n / dumps_time, 'loads': n / loads_time,
+                'dumps_peak': dumps_peak, 'loads_peak': loads_peak,
+            }
+            del payload, encoded
+
+print(json.dumps(results))
+'''
+
+
+def main(argv: Sequence[str] | None = None) -> int:
+    parser = argparse.ArgumentParser(
+        description=__doc__.splitlines()[0],
+        formatter_class=argparse.RawDescriptionHelpFormatter,
+        epilog='\n'.join(__doc__.splitlines()[1:]),
+    )
+    parser.add_argument('--python', default='python3.13')
+    parser.add_argument('--repeat', type=int, default=5)
+    parser.add_argument(
+        '--min-time', type=float, default=.1,
+        help='time each measurement for at least this long (seconds)',
+    )
+    parser.add_argument(
+        '--sizes', default=','.join(SIZES), help='(default: %(default)s)',
+    )
+    benchlib.add_output_args(parser)
+    args = parser.parse_args(argv)
+    sizes = {name: SIZES[name] for name in args.sizes.split(',')}
+
+    measured = json.loads(
+        subprocess.check_output((
+            args.python, '-c', WORKLOAD, json.dumps(sizes),
+            json.dumps(FORMATS), str(args.repeat), str(args.min_time),
+        )),
+    )
+
+    metrics = {}
+    rows = [('', 'encoded', 'dumps', 'loads', 'dumps peak', 'loads peak')]
+    for name, case in measured.items():
+        for key in ('dumps', 'loads'):
+            metrics[f'{name}/{key}'] = benchlib.Metric(
+                case[key], 'B/s', 'higher',
+            )
+            metrics[f'{name}/{key}_peak'] = benchlib.Metric(
+                case[f'{key}_peak'], 'B',
+            )
+        rows.append((
+            name, f'{case["size"]:,} B',
+            f'{case["dumps"] / 2**20:,.0f} MiB/s',
+            f'{case["loads"] / 2**20:,.0f} MiB/s',
+            f'{case["dumps_peak"] / 2**20:,.1f} MiB',
+            f'{case["loads_peak"] / 2**20:,.1f} MiB',
+        ))
+
+    build = benchlib.build_info(args.python)
+    benchlib.write_result(
+        args, 'serialize', metrics,
+        build=build,
+        metadata={
+            'sizes': {name: case['size'] for name, case in measured.items()},
+            'repeat': args.repeat,
+            'min_time': args.min_time,
+        },
+    )
+    benchlib.step_summary(
+        f'## serialize {build["dist"]} {args.flavour}\n\n'
+        f'{benchlib.format_table(rows)}',
+    )
+    return 0
+
+
+if __name__ == '__main__':
+    raise SystemExit(main())
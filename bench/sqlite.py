@@ -0,0 +1,131 @@
+#!/usr/bin/env python3
+"""measure the interpreter's ``sqlite3`` (and the sqlite library it links):
+row by row and ``executemany`` inserts, indexed lookups and an aggregate
+over a wal mode database file
+"""
+from __future__ import annotations
+
+import argparse
+import json
+import statistics
+import subprocess
+import tempfile
+from collections.abc import Sequence
+
+import benchlib
+
+WORKLOAD = '''\
+import json, os, random, sqlite3, sys, time
+
+path = sys.argv[1]
+rows, repeat = int(sys.argv[2]), int(sys.argv[3])
+rng = random.Random(0)
+data = [
+    (i, f'user-{i}', rng.randrange(100), rng.random(), 'x' * rng.randrange(64))
+    for i in range(rows)
+]
+
+def connect():
+    for suffix in ('', '-wal', '-shm'):
+        if os.path.exists(path + suffix):
+            os.remove(path + suffix)
+    db = sqlite3.connect(path)
+    db.execute('PRAGMA journal_mode = WAL')
+    db.execute('PRAGMA synchronous = NORMAL')
+    db.execute(
+        'CREATE TABLE t '
+        '(id INTEGER PRIMARY KEY, name TEXT, grp INT, score REAL, pad TEXT)'
+    )
+    db.execute('CREATE INDEX t_name ON t (name)')
+    return db
+
+def timed(fn):
+    t0 = time.perf_counter()
+    fn()
+    return time.perf_counter() - t0
+
+results = {'insert': [], 'executemany': [], 'lookup': [], 'aggregate': []}
+for _ in range(repeat):
+    db = connect()
+    def insert():
+        with db:
+            for row in data:
+                db.execute('INSERT INTO t VALUES (?, ?, ?, ?, ?)', row)
+    results['insert'].append(rows / timed(insert))
+    db.close()
+
+    db = connect()
+    def executemany():
+        with db:
+            db.executemany('INSERT INTO t VALUES (?, ?, ?, ?, ?)', data)
+    results['executemany'].append(rows / timed(executemany))
+
+    names = [f'user-{rng.randrange(rows)}' for _ in range(rows)]
+    def lookup():
+        for name in names:
+            db.execute('SELECT score FROM t WHERE name = ?', (name,))
+    results['lookup'].append(rows / timed(lookup))
+
+    def aggregate():
+        for _ in range(10):
+            db.execute(
+                'SELECT grp, count(*), avg(score), max(length(pad)) '
+                'FROM t GROUP BY grp ORDER BY grp'
+            ).fetchall()
+    results['aggregate'].append(10 * rows / timed(aggregate))
+    db.close()
+
+print(json.dumps({'sqlite_version': sqlite3.sqlite_version, **results}))
+'''
+UNITS = {
+    'insert': 'rows/s',
+    'executemany': 'rows/s',
+    'lookup': 'queries/s',
+    'aggregate': 'rows/s',
+}
+
+
+def main(argv: Sequence[str] | None = None) -> int:
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument('--python', default='python3.13')
+    parser.add_argument('--rows', type=int, default=200_000)
+    parser.add_argument('--repeat', type=int, default=5)
+    benchlib.add_output_args(parser)
+    args = parser.parse_args(argv)
+
+    with tempfile.TemporaryDirectory() as tmpdir:
+        out = subprocess.check_output((
+            args.python, '-c', WORKLOAD, f'{tmpdir}/bench.db',
+            str(args.rows), str(args.repeat),
+        ))
+    measured = json.loads(out)
+
+    metrics = {}
+    rows = [('', f'sqlite {measured["sqlite_version"]}')]
+    for name, unit in UNITS.items():
+        values = measured[name]
+        metric = metrics[name] = benchlib.Metric(
+            statistics.mean(values), unit, 'higher',
+            statistics.stdev(values) if len(values) > 1 else None,
+        )
+        rows.append((name, f'{metric.value:,.0f} {unit}'))
+
+    build = benchlib.build_info(args.python)
+    benchlib.write_result(
+        args, 'sqlite', metrics,
+        build=build,
+        metadata={
+            'sqlite_version': measured['sqlite_version'],
+            'rows': args.rows,
+            'repeat': args.repeat,
+        },
+    )
+    benchlib.step_summary(
+        f'## sqlite {build["dist"]} {args.flavour}\n\n'
+        f'{benchlib.format_table(rows)}',
+    )
+    return 0
+
+
+if __name__ == '__main__':
+    raise SystemExit(main())
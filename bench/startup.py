@@ -0,0 +1,222 @@
+#!/usr/bin/env python3
+"""measure interpreter startup and first-import latency
+
+the configurations are the default, ``-X frozen_modules=off`` (the gain from
+the frozen startup modules) and optionally a zipped stdlib, each measured as
+- ``startup``: wall time of ``python -c pass``
+- ``import``: in-process time of the first import of a typical service's
+  stdlib modules
+- ``file_syscalls``: number of file related syscalls made by the import
+  (only when strace is available)
+"""
+from __future__ import annotations
+
+import argparse
+import os
+import shutil
+import statistics
+import subprocess
+import tempfile
+import time
+from collections.abc import Sequence
+from typing import NamedTuple
+
+import benchlib
+
+IMPORTS = (
+    'argparse', 'asyncio', 'base64', 'collections', 'dataclasses',
+    'datetime', 'decimal', 'email.message', 'enum', 'functools',
+    'http.client', 'json', 'logging', 'pathlib', 're', 'socket', 'ssl',
+    'subprocess', 'tempfile', 'typing', 'urllib.request', 'uuid',
+)
+IMPORT_SCRIPT = f'''\
+import time
+t0 = time.perf_counter()
+import {", ".join(IMPORTS)}
+print(time.perf_counter() - t0)
+'''
+
+STDLIB_SCRIPT = 'import sysconfig; print(sysconfig.get_path("stdlib"))'
+
+
+class Config(NamedTuple):
+    name: str
+    args: tuple[str, ...] = ()
+    env: tuple[tuple[str, str], ...] = ()
+
+
+def _env(config: Config) -> dict[str, str]:
+    return {**os.environ, **dict(config.env)}
+
+
+def _startup(python: str, config: Config, n: int) -> list[float]:
+    cmd = (python, *config.args, '-c', 'pass')
+    env = _env(config)
+    subprocess.check_call(cmd, env=env)  # warm up the page cache
+    ret = []
+    for _ in range(n):
+        t0 = time.perf_counter()
+        subprocess.check_call(cmd, env=env)
+        ret.append(time.perf_counter() - t0)
+    return ret
+
+
+def _import(python: str, config: Config, n: int) -> list[float]:
+    cmd = (python, *config.args, '-c', IMPORT_SCRIPT)
+    env = _env(config)
+    return [
+        float(subprocess.check_output(cmd, env=env))
+        for _ in range(n)
+    ]
+
+
+def _file_syscalls(python: str, config: Config) -> int | None:
+    with tempfile.TemporaryDirectory() as tmpdir:
+        out = os.path.join(tmpdir, 'strace')
+        ret = subprocess.call(
+            (
+                'strace', '-f', '-c', '-e', 'trace=%file,read', '-o', out,
+                python, *config.args, '-c', IMPORT_SCRIPT,
+            ),
+            env=_env(config),
+            stdout=subprocess.DEVNULL,
+        )
+        if ret:  # most likely ptrace is not permitted
+            return None
+        with open(out) as f:
+            return _total_calls(f.read())
+
+
+def _total_calls(summary: str) -> int:
+    """the calls of the ``total`` row of an ``strace -c`` summary
+
+    the columns are right aligned under their header and blank when there's
+    nothing to show (``errors`` without errors, ``usecs/call`` of the total
+    on focal), so the one ending under ``calls`` is read
+
+    strace 5.5 (focal):
+
+    >>> _total_calls('''
+    ... % time     seconds  usecs/call     calls    errors syscall
+    ... ------ ----------- ----------- --------- --------- ----------------
+    ...  61.54    0.000160           1       112        27 openat
+    ...  38.46    0.000100           0       204           read
+    ... ------ ----------- ----------- --------- --------- ----------------
+    ... 100.00    0.000260                   316        27 total
+    ... ''')
+    316
+    >>> _total_calls('''
+    ... % time     seconds  usecs/call     calls    errors syscall
+    ... ------ ----------- ----------- --------- --------- ----------------
+    ... 100.00    0.000100           0       204           read
+    ... ------ ----------- ----------- --------- --------- ----------------
+    ... 100.00    0.000100                   204           total
+    ... ''')
+    204
+
+    strace 5.16 (jammy):
+
+    >>> _total_calls('''
+    ... % time     seconds  usecs/call     calls    errors syscall
+    ... ------ ----------- ----------- --------- --------- ------------------
+    ...  61.54    0.000160           1       112        27 openat
+    ...  38.46    0.000100           0       204           read
+    ... ------ ----------- ----------- --------- --------- ------------------
+    ... 100.00    0.000260           0       316        27 total
+    ... ''')
+    316
+    """
+    lines = summary.splitlines()
+    header = next(line for line in lines if line.startswith('% time'))
+    end = header.index('calls') + len('calls')
+    total = next(line for line in lines if line.split()[-1:] == ['total'])
+    return int(total[:end].split()[-1])
+
+
+def _filesystem(path: str) -> str | None:
+    """type of the filesystem holding path (overlay in a container)"""
+    best, fstype = '', None
+    with open('/proc/mounts') as f:
+        for line in f:
+            _, mountpoint, mount_fstype, *_ = line.split()
+            if (
+                    path.startswith(mountpoint) and
+                    len(mountpoint) > len(best)
+            ):
+                best, fstype = mountpoint, mount_fstype
+    return fstype
+
+
+def main(argv: Sequence[str] | None = None) -> int:
+    parser = argparse.ArgumentParser(
+        description=__doc__.splitlines()[0],
+        formatter_class=argparse.RawDescriptionHelpFormatter,
+        epilog='\n'.join(__doc__.splitlines()[1:]),
+    )
+    parser.add_argument('--python', default='python3.13')
+    parser.add_argument(
+        '--zip',
+        help='also measure with this stdlib zip (see tools/zip-stdlib) '
+             'first on sys.path',
+    )
+    parser.add_argument('--runs', type=int, default=50)
+    benchlib.add_output_args(parser)
+    args = parser.parse_args(argv)
+
+    configs = [
+        Config('default'),
+        Config('frozen_off', args=('-X', 'frozen_modules=off')),
+    ]
+    if args.zip:
+        configs.append(Config('zip', env=(('PYTHONPATH', args.zip),)))
+
+    metrics = {}
+    rows = [('config', 'startup', 'import', 'file syscalls')]
+    for config in configs:
+        startup = _startup(args.python, config, args.runs)
+        imports = _import(args.python, config, args.runs)
+        metrics[f'{config.name}/startup'] = benchlib.Metric(
+            statistics.mean(startup), 's', 'lower', statistics.stdev(startup),
+        )
+        metrics[f'{config.name}/import'] = benchlib.Metric(
+            statistics.mean(imports), 's', 'lower', statistics.stdev(imports),
+        )
+        syscalls = '-'
+        calls = None
+        if shutil.which('strace'):
+            calls = _file_syscalls(args.python, config)
+        if calls is not None:
+            metrics[f'{config.name}/file_syscalls'] = benchlib.Metric(
+                calls, 'calls', 'lower',
+            )
+            syscalls = str(calls)
+        rows.append((
+            config.name,
+            f'{statistics.mean(startup) * 1e3:.2f} ms',
+            f'{statistics.mean(imports) * 1e3:.2f} ms',
+            syscalls,
+        ))
+
+    build = benchlib.build_info(args.python)
+    stdlib = subprocess.check_output(
+        (args.python, '-c', STDLIB_SCRIPT), text=True,
+    ).strip()
+    benchlib.write_result(
+        args, 'startup', metrics,
+        build=build,
+        metadata={
+            'configs': [c._asdict() for c in configs],
+            'imports': IMPORTS,
+            'runs': args.runs,
+            'filesystem': _filesystem(stdlib),
+        },
+    )
+    benchlib.step_summary(
+        f'## startup {build["dist"]} {args.flavour}\n\n'
+        f'{benchlib.format_table(rows)}',
+    )
+    return 0
+
+
+if __name__ == '__main__':
+    raise SystemExit(main())
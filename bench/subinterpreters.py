@@ -0,0 +1,255 @@
+#!/usr/bin/env python3
+"""compare subinterpreters (each with its own gil) with threads and
+processes on the same interpreter: cost of creating one, scaling of cpu
+bound work over 1..N workers and queue message throughput
+
+subinterpreters are driven through ``test.support.interpreters`` (the
+high-level wrapper of ``_interpreters`` and ``_interpqueues`` in 3.13), each
+one running in its own thread.  processes are forked.
+
+``Queue.get`` of the 3.13 interpreter queues polls, sleeping 10 ms whenever
+the queue is empty: ``queue/subinterpreters`` measures that floor as soon as
+the consumer catches up with the producer, not only the cost of a message.
+"""
+from __future__ import annotations
+
+import argparse
+import json
+import os
+import subprocess
+from collections.abc import Sequence
+
+import benchlib
+
+MODES = ('threads', 'subinterpreters', 'processes')
+
+WORKLOAD = '''\
+import json, multiprocessing, queue, sys, threading, time
+from concurrent.futures import ProcessPoolExecutor
+from test.support import interpreters
+from test.support.interpreters import queues
+
+workers = json.loads(sys.argv[1])
+n, messages, repeat = map(int, sys.argv[2:])
+ctx = multiprocessing.get_context('fork')
+
+WORK = """
+def work(n):
+    total = 0
+    for i in range(n):
+        total += i * i % 7
+    return total
+"""
+exec(WORK)
+
+def best(fn, *args):
+    ret = float('inf')
+    for _ in range(repeat):
+        t0 = time.perf_counter()
+        fn(*args)
+        ret = min(ret, time.perf_counter() - t0)
+    return ret
+
+def join_all(threads):
+    for t in threads:
+        t.start()
+    for t in threads:
+        t.join()
+
+results = {}
+
+def create_subinterpreters():
+    for _ in range(10):
+        interpreters.create().close()
+
+def create_threads():
+    join_all([threading.Thread(target=int) for _ in range(10)])
+
+def create_processes():
+    for _ in range(10):
+        p = ctx.Process(target=int)
+        p.start()
+        p.join()
+
+for mode, fn in (
+        ('processes', create_processes),
+        ('threads', create_threads),
+        ('subinterpreters', create_subinterpreters),
+):
+    results[f'create/{mode}'] = best(fn) / 10
+
+# fork while no other thread is alive
+for count in workers:
+    with ProcessPoolExecutor(count, mp_context=ctx) as pool:
+        list(pool.map(work, [0] * count))
+        results[f'processes/{count}'] = best(
+            lambda: list(pool.map(work, [n] * count)),
+        )
+
+for count in workers:
+    results[f'threads/{count}'] = best(
+        lambda: join_all([
+            threading.Thread(target=work, args=(n,)) for _ in range(count)
+        ]),
+    )
+
+for count in workers:
+    interps = [interpreters.create() for _ in range(count)]
+    for interp in interps:
+        interp.exec(WORK)
+    results[f'subinterpreters/{count}'] = best(
+        lambda: join_all([
+            threading.Thread(target=interp.exec, args=(f'work({n})',))
+            for interp in interps
+        ]),
+    )
+    for interp in interps:
+        interp.close()
+
+def produce(q):
+    for i in range(messages):
+        q.put(i)
+
+errors = []
+
+def checked(fn, *args):
+    # a producer thread's exception (a failed interp.exec) ends the thread,
+    # the consumer raises it rather than wait for messages forever
+    try:
+        fn(*args)
+    except BaseException as e:
+        errors.append(e)
+        raise
+
+def consume(q, producer):
+    producer.start()
+    for _ in range(messages):
+        while True:
+            try:
+                q.get(timeout=1)
+                break
+            except queue.Empty:
+                if producer.is_alive():
+                    continue
+                elif errors:
+                    raise errors.pop()
+                else:
+                    raise RuntimeError(f'{producer} exited early')
+    producer.join()
+
+q = ctx.Queue()
+results['queue/processes'] = messages / best(
+    lambda: consume(q, ctx.Process(target=produce, args=(q,))),
+)
+q = queue.Queue()
+results['queue/threads'] = messages / best(
+    lambda: consume(
+        q, threading.Thread(target=checked, args=(produce, q)),
+    ),
+)
+interp = interpreters.create()
+q = queues.create()
+interp.exec('from test.support.interpreters import queues')
+interp.prepare_main(q=q, messages=messages)
+interp.exec("""
+def produce():
+    for i in range(messages):
+        q.put(i)
+""")
+results['queue/subinterpreters'] = messages / best(
+    lambda: consume(
+        q,
+        threading.Thread(target=checked, args=(interp.exec, 'produce()')),
+    ),
+)
+interp.close()
+
+print(json.dumps(results))
+'''
+
+
+def main(argv: Sequence[str] | None = None) -> int:
+    parser = argparse.ArgumentParser(
+        description=__doc__.splitlines()[0],
+        formatter_class=argparse.RawDescriptionHelpFormatter,
+        epilog='\n'.join(__doc__.splitlines()[1:]),
+    )
+    parser.add_argument('--python', default='python3.13')
+    parser.add_argument(
+        '--workers',
+        default=','.join(
+            str(n) for n in (1, 2, 4, 8, 16) if n <= (os.cpu_count() or 1)
+        ),
+        help='(default: %(default)s)',
+    )
+    parser.add_argument(
+        '--work', type=int, default=5_000_000,
+        help='loop iterations per worker',
+    )
+    parser.add_argument('--messages', type=int, default=100_000)
+    parser.add_argument('--repeat', type=int, default=5)
+    benchlib.add_output_args(parser)
+    args = parser.parse_args(argv)
+    workers = [int(n) for n in args.workers.split(',')]
+
+    measured = json.loads(
+        subprocess.check_output((
+            args.python, '-c', WORKLOAD, json.dumps(workers),
+            str(args.work), str(args.messages), str(args.repeat),
+        )),
+    )
+
+    metrics = {}
+    rows = [('', *MODES)]
+    rows.append((
+        'create',
+        *(f'{measured[f"create/{mode}"] * 1e3:.2f} ms' for mode in MODES),
+    ))
+    for mode in MODES:
+        metrics[f'create/{mode}'] = benchlib.Metric(
+            measured[f'create/{mode}'], 's',
+        )
+        metrics[f'queue/{mode}'] = benchlib.Metric(
+            measured[f'queue/{mode}'], 'messages/s', 'higher',
+        )
+    for count in workers:
+        cells = []
+        for mode in MODES:
+            # every worker does the same work: ideally the time stays flat
+            # and the speedup is the number of workers
+            elapsed = measured[f'{mode}/{count}']
+            first = measured[f'{mode}/{workers[0]}']
+            speedup = count / workers[0] * first / elapsed
+            metrics[f'{mode}/{count}'] = benchlib.Metric(elapsed, 's')
+            metrics[f'{mode}/{count}/speedup'] = benchlib.Metric(
+                speedup, 'x', 'higher',
+            )
+            cells.append(f'{elapsed:.2f} s ({speedup:.1f}x)')
+        rows.append((f'{count} workers', *cells))
+    rows.append((
+        'queue',
+        *(f'{measured[f"queue/{mode}"]:,.0f} msg/s' for mode in MODES),
+    ))
+
+    build = benchlib.build_info(args.python)
+    benchlib.write_result(
+        args, 'subinterpreters', metrics,
+        build=build,
+        metadata={
+            'workers': workers,
+            'work': args.work,
+            'messages': args.messages,
+            'repeat': args.repeat,
+            # test.support.interpreters.queues.Queue.get
+            'queue_poll_interval': .01,
+        },
+    )
+    benchlib.step_summary(
+        f'## subinterpreters {build["dist"]} {args.flavour}\n\n'
+        f'{benchlib.format_table(rows)}',
+    )
+    return 0
+
+
+if __name__ == '__main__':
+    raise SystemExit(main())
@@ -0,0 +1,181 @@
+#!/usr/bin/env python3
+"""time cpython's regression tests: wall time of every test file (from
+regrtest's ``--junit-xml``), flagging the ones well outside their history
+
+a test file is flagged when it took longer than the median of its previous
+``--window`` nights plus ``--mads`` scaled median absolute deviations, and at
+least ``--min-change`` longer (relative and absolute), so tests which
+usually take a few milliseconds aren't flagged for scheduling noise.
+
+failing tests don't fail this script: their time is recorded all the same
+and the failures are listed in the results.  ``--pgo`` times the pgo
+training subset instead (stored as ``testsuite-pgo``).
+"""
+from __future__ import annotations
+
+import argparse
+import collections
+import os
+import statistics
+import subprocess
+import tempfile
+import xml.etree.ElementTree as ET
+from collections.abc import Sequence
+from typing import Any
+
+import benchlib
+
+
+def _run(args: argparse.Namespace) -> ET.Element:
+    with tempfile.TemporaryDirectory() as tmpdir:
+        junit = os.path.join(tmpdir, 'junit.xml')
+        cmd = [
+            args.python, '-m', 'test', f'--multiprocess={args.jobs}',
+            f'--timeout={args.timeout}', f'--junit-xml={junit}',
+        ]
+        if args.pgo:
+            cmd.append('--pgo')
+        cmd.extend(args.tests)
+        # non-zero when any test failed: the timings are still good
+        subprocess.call(cmd)
+        return ET.parse(junit).getroot()
+
+
+def _times(
+        root: ET.Element,
+) -> tuple[dict[str, float], list[tuple[str, float]], list[str]]:
+    """seconds per test file, per test case and the failed test cases"""
+    files: dict[str, float] = collections.defaultdict(float)
+    cases = []
+    failed = []
+    for case in root.iter('testcase'):
+        # test.test_argparse.TestCase.test_method -> test_argparse
+        name = case.get('name', '')
+        parts = name.split('.')
+        test_file = parts[1] if parts[0] == 'test' and len(parts) > 1 else name
+        seconds = float(case.get('time') or 0)
+        files[test_file] += seconds
+        cases.append((name, seconds))
+        if case.find('failure') is not None or case.find('error') is not None:
+            failed.append(name)
+    return dict(files), cases, failed
+
+
+def _outliers(
+        args: argparse.Namespace,
+        build: dict[str, Any],
+        files: dict[str, float],
+) -> list[dict[str, Any]]:
+    previous = benchlib.history(
+        args.history, build['dist'], args.flavour, args.name,
+        before=args.date,
+    )[-args.window:]
+
+    ret = []
+    for test_file, seconds in sorted(files.items()):
+        values = [
+            r['metrics'][test_file]['value']
+            for r in previous if test_file in r['metrics']
+        ]
+        if len(values) < args.min_history:
+            continue
+        median = statistics.median(values)
+        # scaled to estimate the standard deviation of a normal distribution
+        mad = 1.4826 * statistics.median(abs(v - median) for v in values)
+        limit = max(
+            median + args.mads * mad,
+            median * (1 + args.min_change),
+            median + args.min_seconds,
+        )
+        if seconds > limit:
+            ret.append({
+                'test': test_file,
+                'seconds': seconds,
+                'median': median,
+                'mad': mad,
+                'nights': len(values),
+            })
+    return ret
+
+
+def main(argv: Sequence[str] | None = None) -> int:
+    parser = argparse.ArgumentParser(
+        description=__doc__.splitlines()[0],
+        formatter_class=argparse.RawDescriptionHelpFormatter,
+        epilog='\n'.join(__doc__.splitlines()[1:]),
+    )
+    parser.add_argument(
+        'tests', nargs='*', help='test files to run (default: all of them)',
+    )
+    parser.add_argument('--python', default='python3.13')
+    parser.add_argument('--jobs', type=int, default=os.cpu_count() or 1)
+    parser.add_argument(
+        '--timeout', type=int, default=1200, help='seconds per test file',
+    )
+    parser.add_argument(
+        '--pgo', action='store_true',
+        help='run the pgo training subset of the tests',
+    )
+    parser.add_argument(
+        '--window', type=int, default=30,
+        help='nights of history to compare against (default: %(default)s)',
+    )
+    parser.add_argument('--min-history', type=int, default=5)
+    parser.add_argument('--mads', type=float, default=5)
+    parser.add_argument('--min-change', type=float, default=.25)
+    parser.add_argument(
+        '--min-seconds', type=float, default=.5,
+        help='(default: %(default)s)',
+    )
+    parser.add_argument(
+        '--history', default='history',
+        help='previous results to compare against (default: %(default)s)',
+    )
+    benchlib.add_output_args(parser)
+    args = parser.parse_args(argv)
+    args.name = 'testsuite-pgo' if args.pgo else 'testsuite'
+
+    build = benchlib.build_info(args.python)
+    files, cases, failed = _times(_run(args))
+    outliers = _outliers(args, build, files)
+    slowest = sorted(cases, key=lambda case: case[1], reverse=True)[:50]
+
+    benchlib.write_result(
+        args, args.name,
+        {name: benchlib.Metric(value, 's') for name, value in files.items()},
+        build=build,
+        metadata={
+            'jobs': args.jobs,
+            'tests': len(cases),
+            'failed': failed,
+            'slowest': dict(slowest),
+            'outliers': outliers,
+        },
+    )
+
+    rows = [('test', 'time')]
+    for name, seconds in sorted(
+            files.items(), key=lambda kv: kv[1], reverse=True,
+    )[:20]:
+        rows.append((name, f'{seconds:,.2f} s'))
+    benchlib.step_summary(
+        f'## {args.name} {build["dist"]} {args.flavour} '
+        f'({len(files)} files, {len(cases)} tests, {len(failed)} failed, '
+        f'slowest 20)\n\n{benchlib.format_table(rows)}',
+    )
+    if outliers:
+        rows = [('test', 'time', 'median', 'mad', 'nights')]
+        for outlier in outliers:
+            rows.append((
+                outlier['test'], f'{outlier["seconds"]:,.2f} s',
+                f'{outlier["median"]:,.2f} s', f'{outlier["mad"]:,.2f} s',
+                str(outlier['nights']),
+            ))
+        benchlib.step_summary(
+            f'### slower than usual\n\n{benchlib.format_table(rows)}',
+        )
+    return 0
+
+
+if __name__ == '__main__':
+    raise SystemExit(main())
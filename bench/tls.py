@@ -0,0 +1,193 @@
+#!/usr/bin/env python3
+"""measure the interpreter's openssl: tls handshakes and bulk transfer over
+loopback (server and client in the same process) and ``hashlib`` digests of
+large and small messages
+
+the server certificate is a throwaway ecdsa p-256 one from the ``openssl``
+command line tool.
+"""
+from __future__ import annotations
+
+import argparse
+import json
+import os.path
+import statistics
+import subprocess
+import tempfile
+from collections.abc import Sequence
+
+import benchlib
+
+CIPHERS = {
+    'aes128-gcm': 'ECDHE-ECDSA-AES128-GCM-SHA256',
+    'aes256-gcm': 'ECDHE-ECDSA-AES256-GCM-SHA384',
+    'chacha20-poly1305': 'ECDHE-ECDSA-CHACHA20-POLY1305',
+}
+DIGESTS = ('md5', 'sha1', 'sha256', 'sha512', 'sha3_256', 'blake2b')
+
+WORKLOAD = f'''\
+import hashlib, json, socket, ssl, sys, threading, time
+
+cert, key = sys.argv[1:3]
+repeat, duration = int(sys.argv[3]), float(sys.argv[4])
+CIPHERS = {CIPHERS!r}
+DIGESTS = {DIGESTS!r}
+
+def timed(fn):
+    """units per second (as returned by fn) in repeat samples of duration"""
+    ret = []
+    for _ in range(repeat):
+        n = 0
+        t0 = t = time.perf_counter()
+        while t - t0 < duration:
+            n += fn()
+            t = time.perf_counter()
+        ret.append(n / (t - t0))
+    return ret
+
+server_ctx = ssl.SSLContext(ssl.PROTOCOL_TLS_SERVER)
+server_ctx.load_cert_chain(cert, key)
+listener = socket.create_server(('127.0.0.1', 0))
+
+def handle(conn):
+    try:
+        with server_ctx.wrap_socket(conn, server_side=True) as tls:
+            while tls.recv(1 << 16):
+                pass
+    except OSError:  # the client went away mid handshake / record
+        pass
+
+def serve():
+    while True:
+        conn, _ = listener.accept()
+        threading.Thread(target=handle, args=(conn,), daemon=True).start()
+
+threading.Thread(target=serve, daemon=True).start()
+
+def client_ctx(tls12_cipher=None):
+    ctx = ssl.create_default_context(cafile=cert)
+    if tls12_cipher is not None:
+        ctx.maximum_version = ssl.TLSVersion.TLSv1_2
+        ctx.set_ciphers(tls12_cipher)
+    return ctx
+
+def connect(ctx):
+    sock = socket.create_connection(listener.getsockname())
+    return ctx.wrap_socket(sock, server_hostname='localhost')
+
+results = {{}}
+
+for name, ctx in (
+        ('tls1.3', client_ctx()),
+        ('tls1.2', client_ctx(CIPHERS['aes128-gcm'])),
+):
+    def handshake():
+        connect(ctx).close()
+        return 1
+    results[f'handshake/{{name}}'] = timed(handshake)
+
+chunk = bytes(1 << 16)
+for name, cipher in CIPHERS.items():
+    with connect(client_ctx(cipher)) as tls:
+        assert tls.cipher()[0] == cipher, tls.cipher()
+        def send():
+            tls.sendall(chunk)
+            return len(chunk)
+        results[f'bulk/{{name}}'] = timed(send)
+
+big, small = bytes(1 << 20), bytes(64)
+for name in DIGESTS:
+    def digest_big():
+        hashlib.new(name, big).digest()
+        return len(big)
+    def digest_small():
+        for _ in range(1000):
+            hashlib.new(name, small).digest()
+        return 1000
+    results[f'hashlib/{{name}}'] = timed(digest_big)
+    results[f'hashlib/{{name}}/small'] = timed(digest_small)
+
+print(json.dumps({{
+    'openssl': ssl.OPENSSL_VERSION,
+    'digests': {{
+        name: type(hashlib.new(name)).__module__ for name in DIGESTS
+    }},
+    'results': results,
+}}))
+'''
+
+
+def _certificate(tmpdir: str) -> tuple[str, str]:
+    cert = os.path.join(tmpdir, 'cert.pem')
+    key = os.path.join(tmpdir, 'key.pem')
+    subprocess.check_call(
+        (
+            'openssl', 'req', '-x509', '-nodes', '-days', '1',
+            '-newkey', 'ec', '-pkeyopt', 'ec_paramgen_curve:prime256v1',
+            '-subj', '/CN=localhost',
+            '-addext', 'subjectAltName=DNS:localhost',
+            '-keyout', key, '-out', cert,
+        ),
+        stderr=subprocess.DEVNULL,
+    )
+    return cert, key
+
+
+def main(argv: Sequence[str] | None = None) -> int:
+    parser = argparse.ArgumentParser(
+        description=__doc__.splitlines()[0],
+        formatter_class=argparse.RawDescriptionHelpFormatter,
+        epilog='\n'.join(__doc__.splitlines()[1:]),
+    )
+    parser.add_argument('--python', default='python3.13')
+    parser.add_argument('--repeat', type=int, default=5)
+    parser.add_argument('--duration', type=float, default=1, help='seconds')
+    benchlib.add_output_args(parser)
+    args = parser.parse_args(argv)
+
+    with tempfile.TemporaryDirectory() as tmpdir:
+        out = subprocess.check_output((
+            args.python, '-c', WORKLOAD, *_certificate(tmpdir),
+            str(args.repeat), str(args.duration),
+        ))
+    measured = json.loads(out)
+
+    metrics = {}
+    rows = [('', measured['openssl'])]
+    for name, values in measured['results'].items():
+        if name.startswith('handshake/'):
+            unit = 'handshakes/s'
+        elif name.endswith('/small'):
+            unit = 'digests/s'
+        else:
+            unit = 'B/s'
+        metric = metrics[name] = benchlib.Metric(
+            statistics.mean(values), unit, 'higher',
+            statistics.stdev(values) if len(values) > 1 else None,
+        )
+        if unit == 'B/s':
+            rows.append((name, f'{metric.value / 2**20:,.0f} MiB/s'))
+        else:
+            rows.append((name, f'{metric.value:,.0f} {unit}'))
+
+    build = benchlib.build_info(args.python)
+    benchlib.write_result(
+        args, 'tls', metrics,
+        build=build,
+        metadata={
+            'openssl': measured['openssl'],
+            'digests': measured['digests'],
+            'ciphers': CIPHERS,
+            'repeat': args.repeat,
+            'duration': args.duration,
+        },
+    )
+    benchlib.step_summary(
+        f'## tls {build["dist"]} {args.flavour}\n\n'
+        f'{benchlib.format_table(rows)}',
+    )
+    return 0
+
+
+if __name__ == '__main__':
+    raise SystemExit(main())
@@ -0,0 +1,85 @@
+"""batch processing of records: log line parsing, csv, json and pickle
+round trips, grouping and compression"""
+from __future__ import annotations
+
+import collections
+import csv
+import dataclasses
+import datetime
+import gzip
+import io
+import json
+import pickle
+import random
+import re
+
+RECORDS = 20000
+LOG_RE = re.compile(
+    r'(?P<host>\S+) - - \[(?P<when>[^]]+)\] "(?P<method>[A-Z]+) '
+    r'(?P<path>\S+) HTTP/1\.1" (?P<status>\d{3}) (?P<size>\d+)',
+)
+
+
+@dataclasses.dataclass
+class Hit:
+    host: str
+    when: datetime.datetime
+    method: str
+    path: str
+    status: int
+    size: int
+
+
+def log_lines(rng: random.Random) -> list[str]:
+    start = datetime.datetime(2024, 1, 1, tzinfo=datetime.timezone.utc)
+    return [
+        f'10.0.{rng.randrange(4)}.{rng.randrange(256)} - - '
+        f'[{start + datetime.timedelta(seconds=i):%d/%b/%Y:%H:%M:%S %z}] '
+        f'"{rng.choice(("GET", "POST"))} /api/{rng.randrange(50)}/'
+        f'{rng.choice(("a", "b", "c"))} HTTP/1.1" '
+        f'{rng.choice((200, 200, 200, 404, 500))} {rng.randrange(100000)}'
+        for i in range(RECORDS)
+    ]
+
+
+def parse(line: str) -> Hit:
+    m = LOG_RE.match(line)
+    assert m is not None, line
+    return Hit(
+        m['host'],
+        datetime.datetime.strptime(m['when'], '%d/%b/%Y:%H:%M:%S %z'),
+        m['method'], m['path'], int(m['status']), int(m['size']),
+    )
+
+
+def main() -> None:
+    hits = [parse(line) for line in log_lines(random.Random(0))]
+
+    by_path: dict[str, list[int]] = collections.defaultdict(list)
+    for hit in hits:
+        by_path[hit.path].append(hit.size)
+    summary = {
+        path: {'n': len(sizes), 'total': sum(sizes), 'max': max(sizes)}
+        for path, sizes in sorted(by_path.items())
+    }
+    errors = collections.Counter(h.host for h in hits if h.status >= 500)
+
+    buf = io.StringIO()
+    fields = [field.name for field in dataclasses.fields(Hit)]
+    writer = csv.DictWriter(buf, fieldnames=fields)
+    writer.writeheader()
+    for hit in hits:
+        writer.writerow(
+            {**dataclasses.asdict(hit), 'when': hit.when.isoformat()},
+        )
+    rows = list(csv.DictReader(io.StringIO(buf.getvalue())))
+    assert len(rows) == len(hits)
+
+    doc = json.dumps({'summary': summary, 'errors': errors, 'rows': rows})
+    assert json.loads(doc)['summary'] == summary
+    assert pickle.loads(pickle.dumps(hits)) == hits
+    assert gzip.decompress(gzip.compress(doc.encode())) == doc.encode()
+
+
+if __name__ == '__main__':
+    main()
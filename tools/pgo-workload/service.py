@@ -0,0 +1,88 @@
+"""an asyncio http/1.1 keep-alive service over loopback: request parsing,
+routing, json bodies, in one process (client and server tasks)"""
+from __future__ import annotations
+
+import asyncio
+import json
+import urllib.parse
+
+CLIENTS = 16
+REQUESTS = 300
+ITEMS = {i: {'id': i, 'name': f'item {i}', 'tags': ['a', 'b'][:i % 3]}
+         for i in range(100)}
+
+
+def route(method: str, target: str, body: bytes) -> tuple[int, object]:
+    url = urllib.parse.urlsplit(target)
+    query = urllib.parse.parse_qs(url.query)
+    parts = url.path.strip('/').split('/')
+    if parts[0] != 'items':
+        return 404, {'error': 'not found'}
+    elif method == 'GET' and len(parts) == 1:
+        limit = int(query.get('limit', ['10'])[0])
+        return 200, list(ITEMS.values())[:limit]
+    elif method == 'GET':
+        item = ITEMS.get(int(parts[1]))
+        return (200, item) if item else (404, {'error': 'no such item'})
+    elif method == 'POST':
+        item = json.loads(body)
+        return 201, {**item, 'id': len(ITEMS)}
+    else:
+        return 405, {'error': 'method not allowed'}
+
+
+async def handle(
+        reader: asyncio.StreamReader,
+        writer: asyncio.StreamWriter,
+) -> None:
+    try:
+        while True:
+            head = await reader.readuntil(b'\r\n\r\n')
+            request, *lines = head.decode('latin-1').split('\r\n')
+            method, target, _ = request.split(' ')
+            headers = {}
+            for line in filter(None, lines):
+                name, _, value = line.partition(':')
+                headers[name.strip().lower()] = value.strip()
+            body = await reader.readexactly(
+                int(headers.get('content-length', 0)),
+            )
+            status, payload = route(method, target, body)
+            data = json.dumps(payload).encode()
+            writer.write(
+                f'HTTP/1.1 {status} X\r\n'
+                f'Content-Type: application/json\r\n'
+                f'Content-Length: {len(data)}\r\n\r\n'.encode() + data,
+            )
+            await writer.drain()
+    except asyncio.IncompleteReadError:
+        writer.close()
+
+
+async def client(port: int, n: int) -> None:
+    reader, writer = await asyncio.open_connection('127.0.0.1', port)
+    for i in range(REQUESTS):
+        if i % 5 == 4:
+            body = json.dumps({'name': f'new {n} {i}', 'tags': []}).encode()
+            head = f'POST /items HTTP/1.1\r\nContent-Length: {len(body)}'
+        else:
+            body = b''
+            target = f'/items/{i % 120}' if i % 2 else f'/items?limit={i % 20}'
+            head = f'GET {target} HTTP/1.1\r\nHost: localhost'
+        writer.write(f'{head}\r\n\r\n'.encode() + body)
+        head_in = await reader.readuntil(b'\r\n\r\n')
+        length = int(head_in.split(b'Content-Length: ')[1].split(b'\r\n')[0])
+        json.loads(await reader.readexactly(length))
+    writer.close()
+    await writer.wait_closed()
+
+
+async def main() -> None:
+    server = await asyncio.start_server(handle, '127.0.0.1', 0)
+    port = server.sockets[0].getsockname()[1]
+    async with server:
+        await asyncio.gather(*(client(port, n) for n in range(CLIENTS)))
+
+
+if __name__ == '__main__':
+    asyncio.run(main())
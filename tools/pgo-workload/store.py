@@ -0,0 +1,83 @@
+"""an order store on sqlite: transactions of inserts, updates, joins and
+aggregates, through the sqlite3 module's row factories and adapters"""
+from __future__ import annotations
+
+import decimal
+import random
+import sqlite3
+
+CUSTOMERS = 500
+ORDERS = 5000
+
+SCHEMA = '''\
+CREATE TABLE customer (id INTEGER PRIMARY KEY, name TEXT, region TEXT);
+CREATE TABLE product (id INTEGER PRIMARY KEY, name TEXT, price TEXT);
+CREATE TABLE orders (
+    id INTEGER PRIMARY KEY, customer INTEGER REFERENCES customer,
+    status TEXT
+);
+CREATE TABLE line (
+    orders INTEGER REFERENCES orders, product INTEGER REFERENCES product,
+    quantity INTEGER
+);
+CREATE INDEX line_orders ON line (orders);
+'''
+
+
+def main() -> None:
+    rng = random.Random(0)
+    sqlite3.register_adapter(decimal.Decimal, str)
+    db = sqlite3.connect(':memory:')
+    db.row_factory = sqlite3.Row
+    db.executescript(SCHEMA)
+
+    with db:
+        db.executemany(
+            'INSERT INTO customer VALUES (?, ?, ?)',
+            ((i, f'customer {i}', rng.choice('NESW'))
+             for i in range(CUSTOMERS)),
+        )
+        db.executemany(
+            'INSERT INTO product VALUES (?, ?, ?)',
+            ((i, f'product {i}', decimal.Decimal(rng.randrange(100, 10000))
+              / 100) for i in range(200)),
+        )
+    for i in range(ORDERS):
+        with db:
+            db.execute(
+                'INSERT INTO orders VALUES (?, ?, ?)',
+                (i, rng.randrange(CUSTOMERS), 'open'),
+            )
+            db.executemany(
+                'INSERT INTO line VALUES (?, ?, ?)',
+                ((i, rng.randrange(200), rng.randrange(1, 5))
+                 for _ in range(rng.randrange(1, 6))),
+            )
+            if i % 10 == 9:
+                db.execute(
+                    "UPDATE orders SET status = 'shipped' WHERE id = ?",
+                    (i - 5,),
+                )
+
+    for region in 'NESW':
+        for row in db.execute(
+                'SELECT c.name, COUNT(DISTINCT o.id) AS n, '
+                'SUM(l.quantity * CAST(p.price AS REAL)) AS total '
+                'FROM customer c JOIN orders o ON o.customer = c.id '
+                'JOIN line l ON l.orders = o.id '
+                'JOIN product p ON p.id = l.product '
+                'WHERE c.region = ? GROUP BY c.id ORDER BY total DESC '
+                'LIMIT 20',
+                (region,),
+        ):
+            dict(row)
+    for i in range(0, ORDERS, 7):
+        db.execute(
+            'SELECT * FROM line JOIN product ON product.id = line.product '
+            'WHERE line.orders = ?',
+            (i,),
+        ).fetchall()
+
+
+if __name__ == '__main__':
+    main()
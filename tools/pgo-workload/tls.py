@@ -0,0 +1,76 @@
+"""tls sessions through memory bios: handshakes, records both ways and
+hashing, without sockets or threads (the certificate is a throwaway one
+from the ``openssl`` command)"""
+from __future__ import annotations
+
+import hashlib
+import os.path
+import ssl
+import subprocess
+import tempfile
+
+HANDSHAKES = 100
+RECORDS = 200
+
+
+def pump(src: ssl.MemoryBIO, dst: ssl.MemoryBIO) -> None:
+    if src.pending:
+        dst.write(src.read())
+
+
+def session(
+        client_ctx: ssl.SSLContext,
+        server_ctx: ssl.SSLContext,
+) -> tuple[ssl.SSLObject, ssl.SSLObject, list[ssl.MemoryBIO]]:
+    bios = [ssl.MemoryBIO() for _ in range(4)]
+    client = client_ctx.wrap_bio(bios[0], bios[1], server_hostname='localhost')
+    server = server_ctx.wrap_bio(bios[2], bios[3], server_side=True)
+    done = [False, False]
+    while not all(done):
+        for i, obj in enumerate((client, server)):
+            if not done[i]:
+                try:
+                    obj.do_handshake()
+                    done[i] = True
+                except ssl.SSLWantReadError:
+                    pass
+        pump(bios[1], bios[2])
+        pump(bios[3], bios[0])
+    return client, server, bios
+
+
+def main() -> None:
+    with tempfile.TemporaryDirectory() as tmpdir:
+        cert = os.path.join(tmpdir, 'cert.pem')
+        key = os.path.join(tmpdir, 'key.pem')
+        subprocess.check_call(
+            (
+                'openssl', 'req', '-x509', '-nodes', '-days', '1',
+                '-newkey', 'ec', '-pkeyopt', 'ec_paramgen_curve:prime256v1',
+                '-subj', '/CN=localhost', '-addext',
+                'subjectAltName=DNS:localhost',
+                '-keyout', key, '-out', cert,
+            ),
+            stderr=subprocess.DEVNULL,
+        )
+        server_ctx = ssl.SSLContext(ssl.PROTOCOL_TLS_SERVER)
+        server_ctx.load_cert_chain(cert, key)
+        client_ctx = ssl.create_default_context(cafile=cert)
+
+    for _ in range(HANDSHAKES):
+        session(client_ctx, server_ctx)
+
+    client, server, bios = session(client_ctx, server_ctx)
+    digest = hashlib.sha256()
+    for i in range(RECORDS):
+        client.write(bytes(range(64)) * (i % 64 + 1))
+        pump(bios[1], bios[2])
+        data = server.read(1 << 16)
+        digest.update(data)
+        server.write(hashlib.blake2b(data).digest())
+        pump(bios[3], bios[0])
+        client.read(1 << 16)
+
+
+if __name__ == '__main__':
+    main()